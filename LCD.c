@@ -11,115 +11,543 @@
 #include "LCD.h"
 #include <stm32c0xx_hal.h>
 #include <string.h>
-#include <stdlib.h>
+#include <stdarg.h>
+
+/* Private defines -----------------------------------------------------------*/
+
+// Wire time of one expander byte: 8 data bits + ACK
+#define LCD_BYTE_TIME_NS        (9000000000ULL / LCD_I2C_CLOCK_HZ)
+#define LCD_EXEC_TIME_NS        37000ULL  // HD44780 instruction execution time
+
+// Extra idle bytes after each LCD byte so the next EN falling edge comes at
+// least 37 us after the previous one. Two byte times (EN high, EN low of the
+// next nibble) are already on the wire; only fast-mode-plus buses need more.
+#ifndef LCD_EXEC_PAD_BYTES
+#if (2 * LCD_BYTE_TIME_NS) >= LCD_EXEC_TIME_NS
+#define LCD_EXEC_PAD_BYTES      0
+#else
+#define LCD_EXEC_PAD_BYTES      ((LCD_EXEC_TIME_NS - 2 * LCD_BYTE_TIME_NS + \
+                                  LCD_BYTE_TIME_NS - 1) / LCD_BYTE_TIME_NS)
+#endif
+#endif
+
+// Longest chunk per transaction: the address byte plus data within the hold time
+#if (LCD_BUS_MAX_HOLD_US > 0)
+#define LCD_BUS_CHUNK_MAX       ((LCD_BUS_MAX_HOLD_US * 1000ULL) / LCD_BYTE_TIME_NS > 1 ? \
+                                 (uint16_t)((LCD_BUS_MAX_HOLD_US * 1000ULL) / LCD_BYTE_TIME_NS - 1) : 1)
+#else
+#define LCD_BUS_CHUNK_MAX       LCD_TX_BUFFER_SIZE
+#endif
+
+// Expander bytes per LCD byte (two nibbles, EN high + EN low each)
+#define LCD_BYTE_WIRE_COST      (4 + LCD_EXEC_PAD_BYTES)
+
+#define LCD_ADDR_UNKNOWN        0xFF  // Address counter position not known
+
+// Register shadows (LCD_HandleTypeDef.stale bits)
+#define LCD_REG_DISPLAY         0x01  // Display control
+#define LCD_REG_ENTRY           0x02  // Entry mode set
+#define LCD_REG_FUNCTION        0x04  // Function set
+#define LCD_REG_ALL             (LCD_REG_DISPLAY | LCD_REG_ENTRY | LCD_REG_FUNCTION)
+
+#define LCD_BROADCAST_CHUNK     8     // LCD bytes encoded per broadcast pass
+
+// LCD_Printf conversion flags
+#define LCD_FMT_ZERO            0x01  // '0': pad numbers with zeros
+#define LCD_FMT_LEFT            0x02  // '-': pad on the right
+#define LCD_FMT_MAX_WIDTH       80    // Widest field: a full DDRAM line
+#define LCD_FMT_MAX_PRECISION   6     // Most %f decimals LCD_EmitFloat prints
+
+#if (LCD_ROWS == 1)
+// DDRAM address after a write: 1-line mode has one line of 0x00-0x4F
+#define LCD_NEXT_ADDR(a)        ((a) == 0x4F ? 0x00 : (a) + 1)
+#define LCD_PREV_ADDR(a)        ((a) == 0x00 ? 0x4F : (a) - 1)
+#define LCD_INIT_LINES          LCD_1LINE
+#else
+// DDRAM address after a write: line 1 ends at 0x27, line 2 at 0x67
+#define LCD_NEXT_ADDR(a)        ((a) == 0x27 ? 0x40 : ((a) == 0x67 ? 0x00 : (a) + 1))
+#define LCD_PREV_ADDR(a)        ((a) == 0x40 ? 0x27 : ((a) == 0x00 ? 0x67 : (a) - 1))
+#define LCD_INIT_LINES          LCD_2LINE
+#endif
+
+// DDRAM address of the first column of a row: rows 2 and 3 continue rows
+// 0 and 1 at column 'cols' (0x14/0x54 on 20x4, 0x10/0x50 on 16x4)
+#define LCD_ROW_ADDR(row, cols) ((((row) & 1) ? 0x40 : 0x00) + (((row) & 2) ? (cols) : 0))
+
+// Geometry of a handle, constants with LCD_FIXED_GEOMETRY
+#if LCD_FIXED_GEOMETRY
+#define LCD_GEO_ROWS(h)         ((void)(h), LCD_ROWS)
+#define LCD_GEO_COLS(h)         ((void)(h), LCD_COLS)
+#define LCD_GEO_OFFSET(h, row)  ((void)(h), LCD_ROW_ADDR(row, LCD_COLS))
+#else
+#define LCD_GEO_ROWS(h)         ((h)->rows)
+#define LCD_GEO_COLS(h)         ((h)->cols)
+#define LCD_GEO_OFFSET(h, row)  ((h)->row_offsets[row])
+#endif
+
+#define LCD_POWER_ON_MS         50    // Vcc rise to first function set (> 40 ms)
+#define LCD_INIT_WAIT_US        100   // Between power-on function sets
+#define LCD_CLEAR_WAIT_US       1600  // Clear display / return home (1.52 ms)
+#define LCD_INIT_TIMEOUT_MS     50    // Max time to drain the queue during init
+#define LCD_INIT_SPIN_US        200   // Shorter init waits are busy-waited
+#define LCD_INIT_FUNCTION       (LCD_FUNCTION_SET | LCD_4BIT_MODE | LCD_INIT_LINES | LCD_5x8DOTS)
+#define LCD_PROBE_TIMEOUT_MS    1     // Per address; a missing device NACKs at once
+
+// LCD_HandleTypeDef.init_step past the last step of lcd_init_steps
+#define LCD_INIT_FAILED         0xFE  // Sequence aborted, the LCD did not answer
+#define LCD_INIT_DONE           0xFF  // Display ready
+
+#define LCD_IDLE_BYTE           LCD_BACKLIGHT  // EN low, RS low: no strobe
+#define LCD_BUSY_FLAG           0x80  // Busy flag in the status byte
+
+#define LCD_IS_ASYNC()          (hlcd->transport->submit != NULL)
+#define LCD_INIT_PENDING()      (hlcd->init_step < LCD_INIT_FAILED)
+
+#if (LCD_TRANSPORT == LCD_TRANSPORT_DMA)
+#define LCD_HAL_TRANSPORT       (&LCD_Transport_HAL_DMA)
+#elif (LCD_TRANSPORT == LCD_TRANSPORT_IT)
+#define LCD_HAL_TRANSPORT       (&LCD_Transport_HAL_IT)
+#else
+#define LCD_HAL_TRANSPORT       (&LCD_Transport_HAL)
+#endif
+
+/* Private types -------------------------------------------------------------*/
+
+// One step of the power-on sequence
+typedef struct {
+    uint8_t data;       // Instruction (nibble steps: upper 4 bits only)
+    uint8_t nibble;     // 1: send the upper nibble alone (still 8-bit mode)
+    uint16_t wait_us;   // Datasheet wait after the step
+} LCD_InitStepTypeDef;
 
 /* Private variables ---------------------------------------------------------*/
-static I2C_HandleTypeDef* hi2c_lcd = NULL;
-static uint8_t lcd_addr = 0x27 << 1; // Default I2C address untuk PCF8574
+
+// Handle behind the single-display API (LCD_Init, LCD_PrintString, ...)
+static LCD_HandleTypeDef lcd_default;
+static uint8_t lcd_default_addr = LCD_I2C_ADDRESS; // LCD_ADDR_AUTO until probed
+
+// Initialized handles, for LCD_Process and the HAL completion callbacks
+static LCD_HandleTypeDef* lcd_handles = NULL;
+
+// Bus reserved for another device with LCD_BusAcquire (NULL = none)
+static void* volatile lcd_bus_owner = NULL;
+
+// Initial sequence untuk 4-bit mode. The 37 us of the byte steps is
+// covered by bus byte time.
+static const LCD_InitStepTypeDef lcd_init_steps[] = {
+    { 0x03 << 4, 1, 4500 },                                           // Function set (8-bit), > 4.1 ms
+    { 0x03 << 4, 1, LCD_INIT_WAIT_US },                               // Function set (8-bit)
+    { 0x03 << 4, 1, LCD_INIT_WAIT_US },                               // Function set (8-bit)
+    { 0x02 << 4, 1, LCD_INIT_WAIT_US },                               // Function set (4-bit)
+    { LCD_INIT_FUNCTION, 0, 0 },                                      // 4-bit, 1/2 lines, 5x8 font
+    { LCD_DISPLAY_CONTROL, 0, 0 },                                    // Display off
+    { LCD_CLEAR_DISPLAY, 0, LCD_CLEAR_WAIT_US },                      // Clear display
+    { LCD_ENTRY_MODE_SET | LCD_ENTRY_LEFT, 0, 0 },                    // Increment, no shift
+    { LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON, 0, 0 },                   // Display on, cursor off
+};
+
+#define LCD_INIT_STEPS          (sizeof(lcd_init_steps) / sizeof(lcd_init_steps[0]))
+
+// Candidates for LCD_ADDR_AUTO (7-bit): PCF8574, then PCF8574A, each from
+// the all-jumpers-open address most backpacks ship with
+static const uint8_t lcd_probe_addrs[] = {
+    0x27, 0x26, 0x25, 0x24, 0x23, 0x22, 0x21, 0x20,
+    0x3F, 0x3E, 0x3D, 0x3C, 0x3B, 0x3A, 0x39, 0x38
+};
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS) && LCD_USE_ENCODE_TABLE
+// Expander bytes of every LCD byte with RS low: high nibble EN high, EN low,
+// then the low nibble. RS is P0 in every byte, so data ORs in LCD_RS.
+#define LCD_ENC_NIBBLE(n)       ((uint8_t)(((n) & 0xF0) | LCD_BACKLIGHT))
+#define LCD_ENC(b)              { LCD_ENC_NIBBLE(b) | LCD_EN, LCD_ENC_NIBBLE(b), \
+                                  LCD_ENC_NIBBLE((b) << 4) | LCD_EN, LCD_ENC_NIBBLE((b) << 4) }
+#define LCD_ENC4(b)             LCD_ENC(b), LCD_ENC((b) + 1), LCD_ENC((b) + 2), LCD_ENC((b) + 3)
+#define LCD_ENC16(b)            LCD_ENC4(b), LCD_ENC4((b) + 4), LCD_ENC4((b) + 8), LCD_ENC4((b) + 12)
+#define LCD_ENC64(b)            LCD_ENC16(b), LCD_ENC16((b) + 16), LCD_ENC16((b) + 32), LCD_ENC16((b) + 48)
+
+static const uint8_t lcd_encode_tab[256][4] = {
+    LCD_ENC64(0x00), LCD_ENC64(0x40), LCD_ENC64(0x80), LCD_ENC64(0xC0)
+};
+#endif
 
 /* Private function prototypes -----------------------------------------------*/
-static void LCD_WriteNibble(uint8_t data, uint8_t rs);
-static void LCD_WriteByte(uint8_t data, uint8_t rs);
-static void LCD_WriteCommand(uint8_t cmd);
-static void LCD_WriteData(uint8_t data);
-static void LCD_PulseEnable(uint8_t data);
+static LCD_StatusTypeDef LCD_Probe(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c,
+                                   uint8_t* address);
+static void LCD_InitAdvance(LCD_HandleTypeDef* hlcd);
+static LCD_StatusTypeDef LCD_InitSend(LCD_HandleTypeDef* hlcd, const LCD_InitStepTypeDef* step);
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+static void LCD_EncodeNibble(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs);
+#endif
+static void LCD_WriteByte(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs);
+static void LCD_Track(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs);
+static LCD_StatusTypeDef LCD_WriteCommand(LCD_HandleTypeDef* hlcd, uint8_t cmd);
+static LCD_StatusTypeDef LCD_UpdateRegister(LCD_HandleTypeDef* hlcd, uint8_t cmd, uint8_t reg,
+                                            uint8_t shadow, uint8_t value);
+static void LCD_Resync(LCD_HandleTypeDef* hlcd);
+static void LCD_WriteData(LCD_HandleTypeDef* hlcd, uint8_t data);
+static void LCD_EncodeWait(LCD_HandleTypeDef* hlcd, uint32_t us);
+static void LCD_EncodeReady(LCD_HandleTypeDef* hlcd, uint32_t us);
+static LCD_StatusTypeDef LCD_ReadBytes(LCD_HandleTypeDef* hlcd, uint8_t rs, uint8_t* data,
+                                       uint8_t len);
+static LCD_StatusTypeDef LCD_ReadRam(LCD_HandleTypeDef* hlcd, uint8_t cmd, uint8_t* data,
+                                     uint8_t len);
+static uint8_t LCD_Reserve(LCD_HandleTypeDef* hlcd, uint16_t count);
+static void LCD_Put(LCD_HandleTypeDef* hlcd, uint8_t packet);
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+static void LCD_PutBlock(LCD_HandleTypeDef* hlcd, const uint8_t* packets, uint16_t len);
+static uint8_t LCD_EncodeByte(uint8_t* out, uint8_t data, uint8_t rs);
+static void LCD_PutData(LCD_HandleTypeDef* hlcd, const uint8_t* data, uint16_t len);
+#endif
+static void LCD_Commit(LCD_HandleTypeDef* hlcd);
+static void LCD_Kick(LCD_HandleTypeDef* hlcd);
+static void LCD_LatchStatus(LCD_HandleTypeDef* hlcd, LCD_StatusTypeDef status);
+static LCD_StatusTypeDef LCD_FlushTx(LCD_HandleTypeDef* hlcd);
+static LCD_StatusTypeDef LCD_VPrintf(LCD_HandleTypeDef* hlcd, const char* format, va_list args);
+static void LCD_Register(LCD_HandleTypeDef* hlcd);
+static void LCD_KickBus(LCD_HandleTypeDef* hlcd);
+static LCD_HandleTypeDef* LCD_FindInflight(void* ctx);
+static uint16_t LCD_ChunkLen(LCD_HandleTypeDef* hlcd);
+static uint8_t LCD_BroadcastSpan(LCD_HandleTypeDef* hlcd, uint8_t cgram, uint8_t pos,
+                                 uint8_t col, uint8_t len, uint8_t* cmd);
+static LCD_StatusTypeDef LCD_Broadcast(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                       uint8_t cgram, uint8_t pos, uint8_t col,
+                                       const uint8_t* data, uint8_t len);
+static void LCD_PutChar(LCD_HandleTypeDef* hlcd, uint8_t data);
+static void LCD_PutPadding(LCD_HandleTypeDef* hlcd, uint8_t c, int16_t count);
+static void LCD_EmitNumber(LCD_HandleTypeDef* hlcd, uint32_t value, uint8_t base,
+                           uint8_t upper, char sign, uint8_t width, uint8_t flags);
+static void LCD_EmitFloat(LCD_HandleTypeDef* hlcd, float num, uint8_t decimals,
+                          uint8_t width, uint8_t flags);
+static void LCD_Format(LCD_HandleTypeDef* hlcd, const char* format, va_list args);
+#if LCD_USE_FRAMEBUFFER
+static void LCD_FbWrite(LCD_HandleTypeDef* hlcd, uint8_t data);
+static uint32_t LCD_FbWordDiff(const uint8_t* a, const uint8_t* b, uint8_t word);
+static uint8_t LCD_FbDiff(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t* first, uint8_t* last);
+static uint16_t LCD_FbPlan(LCD_HandleTypeDef* hlcd, uint8_t emit, LCD_StatusTypeDef* status);
+static uint8_t* LCD_FbCellAt(LCD_HandleTypeDef* hlcd, uint8_t addr);
+#endif
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
-  * @brief  Initializes LCD with associated I2C handle
+  * @brief  Initializes an LCD with associated I2C handle
+  * @param  hlcd: LCD handle (any storage; no setup needed)
   * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
   * @retval LCD_StatusTypeDef: Status of initialization
   */
-LCD_StatusTypeDef LCD_Init(I2C_HandleTypeDef* hi2c)
+LCD_StatusTypeDef LCDx_Init(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address)
+{
+    if (hi2c == NULL) {
+        return LCD_ERROR;
+    }
+    
+    if (address == LCD_ADDR_AUTO && LCD_Probe(hlcd, hi2c, &address) != LCD_OK) {
+        return LCD_ERROR;  // No backpack answered
+    }
+    
+    return LCDx_InitTransport(hlcd, LCD_HAL_TRANSPORT, hi2c, address);
+}
+
+/**
+  * @brief  Initializes an LCD over any byte transport
+  * @note   Geometry starts as LCD_ROWS x LCD_COLS, see LCDx_SetGeometry
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitTransport(LCD_HandleTypeDef* hlcd, const LCD_TransportTypeDef* transport,
+                                     void* ctx, uint8_t address)
+{
+    uint32_t start = HAL_GetTick();
+    LCD_StatusTypeDef status = LCDx_InitTransportStart(hlcd, transport, ctx, address);
+    
+    // Same sequence as the non-blocking init, waited out here
+    while (status == LCD_BUSY) {
+        if ((HAL_GetTick() - start) > LCD_POWER_ON_MS + LCD_INIT_TIMEOUT_MS) {
+            hlcd->transport = NULL;
+            return LCD_TIMEOUT;
+        }
+        status = LCDx_InitStatus(hlcd);
+    }
+    
+    return status;
+}
+
+/**
+  * @brief  Starts initializing an LCD with associated I2C handle
+  * @note   Returns at once; see LCDx_InitTransportStart
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCDx_InitStart(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address)
 {
     if (hi2c == NULL) {
         return LCD_ERROR;
     }
     
-    hi2c_lcd = hi2c;
+    if (address == LCD_ADDR_AUTO && LCD_Probe(hlcd, hi2c, &address) != LCD_OK) {
+        return LCD_ERROR;  // No backpack answered
+    }
     
-    // Delay untuk inisialisasi LCD
-    HAL_Delay(50);
+    return LCDx_InitTransportStart(hlcd, LCD_HAL_TRANSPORT, hi2c, address);
+}
+
+/**
+  * @brief  Starts initializing an LCD over any byte transport
+  * @note   The power-on sequence is advanced by LCD_Process (or
+  *         LCDx_InitStatus). Draw calls made meanwhile are queued and sent
+  *         once the display is ready, up to LCD_TX_BUFFER_SIZE; with the
+  *         blocking transport a full queue finishes the sequence first.
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCDx_InitTransportStart(LCD_HandleTypeDef* hlcd,
+                                          const LCD_TransportTypeDef* transport,
+                                          void* ctx, uint8_t address)
+{
+    if (hlcd == NULL || transport == NULL || transport->write == NULL ||
+        address == LCD_ADDR_AUTO) {
+        return LCD_ERROR;
+    }
     
-    // Initial sequence untuk 4-bit mode
-    LCD_WriteNibble(0x03 << 4, 0);  // Function set (8-bit)
-    HAL_Delay(5);
-    LCD_WriteNibble(0x03 << 4, 0);  // Function set (8-bit)
-    HAL_Delay(1);
-    LCD_WriteNibble(0x03 << 4, 0);  // Function set (8-bit)
-    HAL_Delay(1);
-    LCD_WriteNibble(0x02 << 4, 0);  // Function set (4-bit)
-    HAL_Delay(1);
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+    // The per-nibble sleeps cannot be queued: see LCD_TIMING_DELAY in LCD.h
+    if (transport->submit != NULL) {
+        return LCD_ERROR;
+    }
+#endif
     
-    // Function set: 4-bit, 2 lines, 5x8 font
-    LCD_WriteCommand(LCD_FUNCTION_SET | LCD_4BIT_MODE | LCD_2LINE | LCD_5x8DOTS);
-    HAL_Delay(1);
+    // Stop callbacks from touching the handle while it is reset
+    hlcd->transport = NULL;
+    LCD_Register(hlcd);
     
-    // Display control: Display off
-    LCD_WriteCommand(LCD_DISPLAY_CONTROL);
-    HAL_Delay(1);
+    hlcd->addr = address;
+    hlcd->ctx = ctx;
+    hlcd->tx_wr = hlcd->tx_head = hlcd->tx_tail = 0;
+    hlcd->tx_inflight = 0;
+    hlcd->tx_overflow = 0;
+    hlcd->tx_status = LCD_OK;
     
-    // Clear display
-    LCD_WriteCommand(LCD_CLEAR_DISPLAY);
-    HAL_Delay(2);
+    // Registers as the power-on sequence leaves them; queued draw calls
+    // are encoded against this state and go out after the sequence
+    hlcd->ac = 0x00;
+    hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+    hlcd->entry_mode = LCD_ENTRY_LEFT;
+    hlcd->display_ctrl = LCD_DISPLAY_ON;
+    hlcd->function_set = LCD_INIT_FUNCTION & ~LCD_FUNCTION_SET;
+    hlcd->stale = 0;
+#if LCD_USE_BUSY_FLAG
+    hlcd->busy_flag = (transport->read != NULL);
+#endif
+    LCDx_SetGeometry(hlcd, LCD_ROWS, LCD_COLS);
     
-    // Entry mode set: Increment, no shift
-    LCD_WriteCommand(LCD_ENTRY_MODE_SET | LCD_ENTRY_LEFT);
-    HAL_Delay(1);
+#if LCD_USE_FRAMEBUFFER
+    // DDRAM is blank after the clear in the sequence
+    memset(hlcd->fb, ' ', sizeof(hlcd->fb));
+    memset(hlcd->fb_sent, ' ', sizeof(hlcd->fb_sent));
+    hlcd->fb_dirty = 0;
+    hlcd->fb_repaint = 0;
+    hlcd->fb_pending = 0;
+    hlcd->fb_row = 0;
+    hlcd->fb_col = 0;
+#endif
     
-    // Display control: Display on, cursor off, blink off
-    LCD_WriteCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON);
-    HAL_Delay(1);
+    // Delay untuk inisialisasi LCD: counted from here, not slept
+    hlcd->init_step = 0;
+    hlcd->init_tick = HAL_GetTick();
+    hlcd->init_wait_ms = LCD_POWER_ON_MS + 1;
+    hlcd->transport = transport;
     
-    return LCD_OK;
+    return LCD_BUSY;
+}
+
+/**
+  * @brief  Reports whether an LCD is ready, advancing its power-on sequence
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: LCD_OK when ready, LCD_BUSY while the
+  *         sequence runs, LCD_ERROR if the LCD did not answer
+  */
+LCD_StatusTypeDef LCDx_InitStatus(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    LCDx_Process(hlcd);
+    
+    if (hlcd->transport == NULL) {
+        return (hlcd->init_step == LCD_INIT_FAILED) ? LCD_ERROR : LCD_NOT_INITIALIZED;
+    }
+    
+    return LCD_INIT_PENDING() ? LCD_BUSY : LCD_OK;
+}
+
+/**
+  * @brief  Attaches to an LCD that may still be set up from before a reset
+  * @note   See LCDx_InitWarmTransport
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitWarm(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address)
+{
+    if (hi2c == NULL) {
+        return LCD_ERROR;
+    }
+    
+    if (address == LCD_ADDR_AUTO && LCD_Probe(hlcd, hi2c, &address) != LCD_OK) {
+        return LCD_ERROR;  // No backpack answered
+    }
+    
+    return LCDx_InitWarmTransport(hlcd, LCD_HAL_TRANSPORT, hi2c, address);
+}
+
+/**
+  * @brief  Attaches to an LCD that may still be set up from before a reset
+  * @note   The HD44780 keeps its mode and RAM across an MCU reset. If the
+  *         busy flag and address counter read back as from a controller in
+  *         4-bit mode, only the function set, display control and entry
+  *         mode are sent again: no power-on wait, no clear. Otherwise (or
+  *         without a read op / RW wiring) this is LCDx_InitTransport. The
+  *         screen keeps its contents; in framebuffer mode they are read
+  *         back into the framebuffer (LCDx_ReadBack), so the first
+  *         LCD_Flush only sends cells drawn since.
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitWarmTransport(LCD_HandleTypeDef* hlcd, const LCD_TransportTypeDef* transport,
+                                         void* ctx, uint8_t address)
+{
+    LCD_StatusTypeDef status;
+    uint8_t first;
+    uint8_t data;
+    uint8_t second;
+    
+    if (transport == NULL || transport->read == NULL) {
+        return LCDx_InitTransport(hlcd, transport, ctx, address);  // Nothing to check with
+    }
+    
+    if (LCDx_InitTransportStart(hlcd, transport, ctx, address) != LCD_BUSY) {
+        return LCD_ERROR;
+    }
+    
+    // Status, one data read, status. In 4-bit mode the data read (two
+    // strobes) moves the counter by one. An 8-bit controller takes every
+    // strobe as a read of its own and shows the upper half of the status
+    // in both nibbles, which never reads as such a step.
+    hlcd->init_step = LCD_INIT_DONE;
+    if (LCD_ReadBytes(hlcd, 0, &first, 1) != LCD_OK || (first & LCD_BUSY_FLAG) ||
+        LCD_ReadBytes(hlcd, 1, &data, 1) != LCD_OK ||
+        LCD_ReadBytes(hlcd, 0, &second, 1) != LCD_OK) {
+        return LCDx_InitTransport(hlcd, transport, ctx, address);
+    }
+    
+    first &= 0x7F;
+    second &= 0x7F;
+    if (second != LCD_NEXT_ADDR(first) && second != LCD_PREV_ADDR(first) &&
+        second != ((first + 1) & 0x3F) && second != ((first - 1) & 0x3F)) {  // CGRAM
+        return LCDx_InitTransport(hlcd, transport, ctx, address);
+    }
+    
+    // Warm: registers as the init sequence would leave them, RAM untouched
+    hlcd->ac = LCD_ADDR_UNKNOWN;
+    hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+    hlcd->stale = LCD_REG_ALL;
+#if LCD_USE_FRAMEBUFFER
+    hlcd->fb_repaint = 0xFF;  // Contents on the glass not known until read back
+#endif
+    LCD_Resync(hlcd);
+    LCD_Commit(hlcd);
+    
+    status = LCDx_WaitIdle(hlcd, LCD_INIT_TIMEOUT_MS);
+#if LCD_USE_FRAMEBUFFER
+    // Start from what the glass shows, or the first flush would blank it
+    if (status == LCD_OK) {
+        status = LCDx_ReadBack(hlcd);
+    }
+#endif
+    return status;
 }
 
 /**
   * @brief  Clears LCD display
+  * @param  hlcd: LCD handle
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_Clear(void)
+LCD_StatusTypeDef LCDx_Clear(LCD_HandleTypeDef* hlcd)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    LCD_WriteCommand(LCD_CLEAR_DISPLAY);
-    HAL_Delay(2); // Clear command needs extra time
+#if LCD_USE_FRAMEBUFFER
+    // Blank the shadow only; LCD_Flush sends the cells that were not blank
+    memset(hlcd->fb, ' ', sizeof(hlcd->fb));
+    hlcd->fb_dirty = 0xFF;
+    hlcd->fb_row = 0;
+    hlcd->fb_col = 0;
     return LCD_OK;
+#else
+    LCD_WriteByte(hlcd, LCD_CLEAR_DISPLAY, 0);
+    LCD_EncodeReady(hlcd, LCD_CLEAR_WAIT_US); // Clear command needs extra time
+    return LCD_FlushTx(hlcd);
+#endif
 }
 
 /**
   * @brief  Sets cursor position
+  * @param  hlcd: LCD handle
   * @param  row: Row number (0-1)
   * @param  col: Column number (0-15)
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_SetCursor(uint8_t row, uint8_t col)
+LCD_StatusTypeDef LCDx_SetCursor(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t col)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
     // Pastikan dalam batas
-    if (row >= 4) row = 3;
-    if (col >= 20) col = 19;
-    
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};  // Untuk LCD 20x4
-    LCD_WriteCommand(LCD_SET_DDRAM_ADDR | (col + row_offsets[row]));
+    if (row >= LCD_GEO_ROWS(hlcd)) row = LCD_GEO_ROWS(hlcd) - 1;
+    if (col >= LCD_GEO_COLS(hlcd)) col = LCD_GEO_COLS(hlcd) - 1;
     
+#if LCD_USE_FRAMEBUFFER
+    hlcd->fb_row = row;
+    hlcd->fb_col = col;
     return LCD_OK;
+#else
+    uint8_t addr = col + LCD_GEO_OFFSET(hlcd, row);
+    
+    // Address counter already there (e.g. left by the previous print)
+    if (hlcd->ac == addr) {
+        return LCD_FlushTx(hlcd);
+    }
+    
+    return LCD_WriteCommand(hlcd, LCD_SET_DDRAM_ADDR | addr);
+#endif
 }
 
 /**
   * @brief  Prints string to LCD
+  * @param  hlcd: LCD handle
   * @param  str: Null-terminated string
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_PrintString(const char* str)
+LCD_StatusTypeDef LCDx_PrintString(LCD_HandleTypeDef* hlcd, const char* str)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
@@ -127,286 +555,2713 @@ LCD_StatusTypeDef LCD_PrintString(const char* str)
         return LCD_ERROR;
     }
     
+#if LCD_USE_FRAMEBUFFER
     while (*str) {
-        LCD_WriteData(*str++);
+        LCD_FbWrite(hlcd, *str++);
     }
     
     return LCD_OK;
+#else
+    // Encode the whole string, then send it as one transaction
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+    LCD_PutData(hlcd, (const uint8_t*)str, (uint16_t)strlen(str));
+#else
+    while (*str) {
+        LCD_WriteData(hlcd, *str++);
+    }
+#endif
+    
+    return LCD_FlushTx(hlcd);
+#endif
 }
 
 /**
   * @brief  Prints integer to LCD
+  * @param  hlcd: LCD handle
   * @param  num: Integer number
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_PrintInt(int32_t num)
+LCD_StatusTypeDef LCDx_PrintInt(LCD_HandleTypeDef* hlcd, int32_t num)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    char buffer[12];
-    itoa(num, buffer, 10);
-    return LCD_PrintString(buffer);
+    uint32_t magnitude = (num < 0) ? 0U - (uint32_t)num : (uint32_t)num;
+    LCD_EmitNumber(hlcd, magnitude, 10, 0, (num < 0) ? '-' : 0, 0, 0);
+    
+#if LCD_USE_FRAMEBUFFER
+    return LCD_OK;
+#else
+    return LCD_FlushTx(hlcd);
+#endif
 }
 
 /**
   * @brief  Prints float to LCD with specified precision
+  * @param  hlcd: LCD handle
   * @param  num: Float number
   * @param  decimals: Number of decimal places (0-6)
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_PrintFloat(float num, uint8_t decimals)
+LCD_StatusTypeDef LCDx_PrintFloat(LCD_HandleTypeDef* hlcd, float num, uint8_t decimals)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    if (decimals > 6) decimals = 6;
+    // Digits go straight to the LCD, no sprintf("%f")
+    LCD_EmitFloat(hlcd, num, decimals, 0, 0);
     
-    char buffer[20];
-    char format[10];
+#if LCD_USE_FRAMEBUFFER
+    return LCD_OK;
+#else
+    return LCD_FlushTx(hlcd);
+#endif
+}
+
+/**
+  * @brief  Prints formatted string (sprintf style)
+  * @note   Supports %d %i %u %x %X %s %c %f %% with '0'/'-' flags, width
+  *         (up to 80) and precision (for %f, 0-6); %ld %lu %lx read a long.
+  *         Characters are formatted straight into the transmit queue or
+  *         framebuffer; no heap and no vsprintf.
+  * @param  hlcd: LCD handle
+  * @param  format: Format string
+  * @param  ...: Variable arguments
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Printf(LCD_HandleTypeDef* hlcd, const char* format, ...)
+{
+    LCD_StatusTypeDef status;
+    va_list args;
     
-    sprintf(format, "%%.%df", decimals);
-    sprintf(buffer, format, num);
+    va_start(args, format);
+    status = LCD_VPrintf(hlcd, format, args);
+    va_end(args);
     
-    return LCD_PrintString(buffer);
+    return status;
 }
 
 /**
-  * @brief  Creates custom character
-  * @param  location: CGRAM location (0-7)
-  * @param  charmap: 8-byte array for character pattern
+  * @brief  Sets up a fixed-width numeric field
+  * @note   Nothing is drawn until the first LCD_FieldUpdate
+  * @param  hlcd: LCD handle
+  * @param  field: Field to set up
+  * @param  row: Row of the first cell
+  * @param  col: Column of the first cell
+  * @param  width: Number of cells (1-LCD_FIELD_MAX_WIDTH)
+  * @param  align: LCD_ALIGN_RIGHT or LCD_ALIGN_LEFT
+  * @param  pad: Fill character (a '0' pad goes after the sign; not allowed
+  *         with LCD_ALIGN_LEFT)
+  * @param  is_signed: 1 to print the value as int32_t, 0 as uint32_t
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_CreateChar(uint8_t location, uint8_t charmap[])
+LCD_StatusTypeDef LCDx_FieldInit(LCD_HandleTypeDef* hlcd, LCD_FieldTypeDef* field, uint8_t row,
+                                 uint8_t col, uint8_t width, LCD_AlignTypeDef align, char pad,
+                                 uint8_t is_signed)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
-    
-    if (location > 7) {
+    // A '0' pad after the digits would change the value shown (5 -> "500")
+    if (field == NULL || width == 0 || width > LCD_FIELD_MAX_WIDTH ||
+        row >= LCD_GEO_ROWS(hlcd) || col >= LCD_GEO_COLS(hlcd) ||
+        (align == LCD_ALIGN_LEFT && pad == '0')) {
         return LCD_ERROR;
     }
     
-    LCD_WriteCommand(LCD_SET_CGRAM_ADDR | (location << 3));
-    
-    for (int i = 0; i < 8; i++) {
-        LCD_WriteData(charmap[i]);
+    // Clip to the end of the row
+    if (col + width > LCD_GEO_COLS(hlcd)) {
+        width = LCD_GEO_COLS(hlcd) - col;
     }
     
+    field->row = row;
+    field->col = col;
+    field->width = width;
+    field->align = align;
+    field->pad = pad;
+    field->is_signed = is_signed;
+    field->value = 0;
+    memset(field->shown, 0, sizeof(field->shown));  // Forces the first draw
+    
     return LCD_OK;
 }
 
 /**
-  * @brief  Displays custom character
-  * @param  location: CGRAM location (0-7)
+  * @brief  Shows a new value in a numeric field, sending only changed cells
+  * @note   Values that do not fit are shown as '#' in every cell. After
+  *         LCD_Clear, call LCD_FieldInit again so the field is redrawn.
+  * @param  hlcd: LCD handle
+  * @param  field: Field set up with LCD_FieldInit
+  * @param  value: Value to show (reinterpreted as uint32_t if unsigned)
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_WriteChar(uint8_t location)
+LCD_StatusTypeDef LCDx_FieldUpdate(LCD_HandleTypeDef* hlcd, LCD_FieldTypeDef* field, int32_t value)
 {
-    if (hi2c_lcd == NULL) {
+    uint8_t cells[LCD_FIELD_MAX_WIDTH];
+    uint8_t digits[10];
+    uint8_t len = 0;
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
-    
-    if (location > 7) {
+    if (field == NULL) {
         return LCD_ERROR;
     }
     
-    LCD_WriteData(location);
+    uint8_t negative = field->is_signed && value < 0;
+    uint32_t magnitude = negative ? 0U - (uint32_t)value : (uint32_t)value;
+    
+    // Unchanged value: nothing to do
+    if (field->shown[0] != 0 && field->value == value) {
+        return LCD_OK;
+    }
+    
+    do {
+        digits[len++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    
+    uint8_t used = len + negative;
+    if (used > field->width) {
+        memset(cells, '#', field->width);
+    } else {
+        uint8_t i = 0;
+        uint8_t pad = field->width - used;
+        uint8_t zero_pad = (field->pad == '0' && field->align == LCD_ALIGN_RIGHT);
+        
+        if (field->align == LCD_ALIGN_RIGHT && !zero_pad) {
+            while (pad) { cells[i++] = field->pad; pad--; }
+        }
+        if (negative) {
+            cells[i++] = '-';
+        }
+        if (zero_pad) {
+            while (pad) { cells[i++] = '0'; pad--; }
+        }
+        while (len) {
+            cells[i++] = digits[--len];
+        }
+        while (pad) { cells[i++] = field->pad; pad--; }
+    }
+    
+    field->value = value;
+    
+#if LCD_USE_FRAMEBUFFER
+    // The framebuffer diff finds the changed cells
+    memcpy(&hlcd->fb[field->row][field->col], cells, field->width);
+    hlcd->fb_dirty |= 1 << field->row;
+    memcpy(field->shown, cells, field->width);
     return LCD_OK;
+#else
+    uint8_t base = LCD_GEO_OFFSET(hlcd, field->row) + field->col;
+    
+    for (uint8_t i = 0; i < field->width; i++) {
+        if (cells[i] == field->shown[i]) {
+            continue;
+        }
+        
+        if (i > 0 && LCD_NEXT_ADDR(hlcd->ac) == base + i) {
+            // One unchanged cell in between: rewrite it instead of addressing
+            LCD_WriteData(hlcd, cells[i - 1]);
+        } else if (hlcd->ac != base + i) {
+            LCD_WriteByte(hlcd, LCD_SET_DDRAM_ADDR | (base + i), 0);
+        }
+        LCD_WriteData(hlcd, cells[i]);
+    }
+    
+    LCD_StatusTypeDef status = LCD_FlushTx(hlcd);
+    if (status == LCD_OK) {
+        memcpy(field->shown, cells, field->width);
+    } else {
+        // Unknown what reached the glass: redraw everything next time
+        memset(field->shown, 0, sizeof(field->shown));
+    }
+    return status;
+#endif
 }
 
 /**
-  * @brief  Turns display on/off
-  * @param  state: 1 for on, 0 for off
+  * @brief  Creates custom character
+  * @param  hlcd: LCD handle
+  * @param  location: CGRAM location (0-7)
+  * @param  charmap: 8-byte array for character pattern
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_Display(uint8_t state)
+LCD_StatusTypeDef LCDx_CreateChar(LCD_HandleTypeDef* hlcd, uint8_t location, uint8_t charmap[])
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    if (state) {
-        LCD_WriteCommand(LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON);
-    } else {
-        LCD_WriteCommand(LCD_DISPLAY_CONTROL);
+    if (location > 7) {
+        return LCD_ERROR;
     }
     
-    return LCD_OK;
+    // Address + 8 pattern rows go out in a single transaction
+    LCD_WriteByte(hlcd, LCD_SET_CGRAM_ADDR | (location << 3), 0);
+    
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+    LCD_PutData(hlcd, charmap, 8);
+#else
+    for (int i = 0; i < 8; i++) {
+        LCD_WriteData(hlcd, charmap[i]);
+    }
+#endif
+    
+    return LCD_FlushTx(hlcd);
 }
 
 /**
-  * @brief  Turns cursor on/off
-  * @param  state: 1 for on, 0 for off
+  * @brief  Displays custom character
+  * @param  hlcd: LCD handle
+  * @param  location: CGRAM location (0-7)
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_Cursor(uint8_t state)
+LCD_StatusTypeDef LCDx_WriteChar(LCD_HandleTypeDef* hlcd, uint8_t location)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    uint8_t command = LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON;
-    
-    if (state) {
-        command |= LCD_CURSOR_ON;
+    if (location > 7) {
+        return LCD_ERROR;
     }
     
-    LCD_WriteCommand(command);
+#if LCD_USE_FRAMEBUFFER
+    LCD_FbWrite(hlcd, location);
     return LCD_OK;
+#else
+    LCD_WriteData(hlcd, location);
+    return LCD_FlushTx(hlcd);
+#endif
 }
 
 /**
-  * @brief  Turns cursor blink on/off
-  * @param  state: 1 for on, 0 for off
-  * @retval LCD_StatusTypeDef: Status of operation
+  * @brief  Prints the same string at the same position on several displays
+  * @note   The characters are encoded once and the encoded bytes are queued
+  *         for every display, then sent display after display. Each display
+  *         gets its own set-address command (row offsets follow its
+  *         geometry) and the string is clipped at its last column. In
+  *         framebuffer mode the string goes into every shadow instead.
+  * @param  hlcds: Displays
+  * @param  count: Number of displays
+  * @param  row: Row number
+  * @param  col: Column number
+  * @param  str: Null-terminated string
+  * @retval LCD_StatusTypeDef: First error of any display, else LCD_OK
   */
-LCD_StatusTypeDef LCD_Blink(uint8_t state)
+LCD_StatusTypeDef LCD_BroadcastString(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                      uint8_t row, uint8_t col, const char* str)
 {
-    if (hi2c_lcd == NULL) {
-        return LCD_NOT_INITIALIZED;
+    size_t len;
+    
+    if (hlcds == NULL || str == NULL) {
+        return LCD_ERROR;
+    }
+    
+    len = strlen(str);
+    if (len > 0xFF) {
+        len = 0xFF;  // Longer than any row anyway
     }
     
-    uint8_t command = LCD_DISPLAY_CONTROL | LCD_DISPLAY_ON;
+#if LCD_USE_FRAMEBUFFER
+    LCD_StatusTypeDef status = LCD_OK;
     
-    if (state) {
-        command |= LCD_BLINK_ON;
+    for (uint8_t i = 0; i < count; i++) {
+        LCD_HandleTypeDef* hlcd = hlcds[i];
+        
+        if (hlcd == NULL || hlcd->transport == NULL) {
+            status = LCD_NOT_INITIALIZED;
+            continue;
+        }
+        if (row >= LCD_GEO_ROWS(hlcd) || col >= LCD_GEO_COLS(hlcd)) {
+            continue;
+        }
+        
+        hlcd->fb_row = row;
+        hlcd->fb_col = col;
+        for (size_t k = 0; k < len; k++) {
+            LCD_FbWrite(hlcd, (uint8_t)str[k]);
+        }
     }
     
-    LCD_WriteCommand(command);
-    return LCD_OK;
+    return status;
+#else
+    return LCD_Broadcast(hlcds, count, 0, row, col, (const uint8_t*)str, (uint8_t)len);
+#endif
 }
 
 /**
-  * @brief  Sets LCD I2C address
-  * @param  address: I2C address (shifted left by 1 bit)
-  * @retval LCD_StatusTypeDef: Status of operation
+  * @brief  Creates the same custom character on several displays
+  * @note   The pattern is encoded once, as with LCD_BroadcastString
+  * @param  hlcds: Displays
+  * @param  count: Number of displays
+  * @param  location: CGRAM location (0-7)
+  * @param  charmap: 8-byte array for character pattern
+  * @retval LCD_StatusTypeDef: First error of any display, else LCD_OK
   */
-LCD_StatusTypeDef LCD_SetAddress(uint8_t address)
+LCD_StatusTypeDef LCD_BroadcastChar(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                    uint8_t location, const uint8_t charmap[])
 {
-    lcd_addr = address;
-    return LCD_OK;
+    if (hlcds == NULL || charmap == NULL || location > 7) {
+        return LCD_ERROR;
+    }
+    
+    return LCD_Broadcast(hlcds, count, 1, location, 0, charmap, 8);
 }
 
 /**
-  * @brief  Scrolls display left
+  * @brief  Turns display on/off
+  * @note   Other display control bits are kept; nothing is sent if the
+  *         register already has the requested value
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_ScrollLeft(void)
+LCD_StatusTypeDef LCDx_Display(LCD_HandleTypeDef* hlcd, uint8_t state)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    LCD_WriteCommand(LCD_CURSOR_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_LEFT);
-    return LCD_OK;
+    uint8_t value = state ? (hlcd->display_ctrl | LCD_DISPLAY_ON)
+                          : (hlcd->display_ctrl & ~LCD_DISPLAY_ON);
+    
+    return LCD_UpdateRegister(hlcd, LCD_DISPLAY_CONTROL, LCD_REG_DISPLAY,
+                              hlcd->display_ctrl, value);
 }
 
 /**
-  * @brief  Scrolls display right
+  * @brief  Turns cursor on/off
+  * @note   Other display control bits are kept; nothing is sent if the
+  *         register already has the requested value
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_ScrollRight(void)
+LCD_StatusTypeDef LCDx_Cursor(LCD_HandleTypeDef* hlcd, uint8_t state)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    LCD_WriteCommand(LCD_CURSOR_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_RIGHT);
-    return LCD_OK;
+    uint8_t value = state ? (hlcd->display_ctrl | LCD_CURSOR_ON)
+                          : (hlcd->display_ctrl & ~LCD_CURSOR_ON);
+    
+    return LCD_UpdateRegister(hlcd, LCD_DISPLAY_CONTROL, LCD_REG_DISPLAY,
+                              hlcd->display_ctrl, value);
 }
 
 /**
-  * @brief  Returns cursor to home position
+  * @brief  Turns cursor blink on/off
+  * @note   Other display control bits are kept; nothing is sent if the
+  *         register already has the requested value
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
   * @retval LCD_StatusTypeDef: Status of operation
   */
-LCD_StatusTypeDef LCD_Home(void)
+LCD_StatusTypeDef LCDx_Blink(LCD_HandleTypeDef* hlcd, uint8_t state)
 {
-    if (hi2c_lcd == NULL) {
+    if (hlcd == NULL || hlcd->transport == NULL) {
         return LCD_NOT_INITIALIZED;
     }
     
-    LCD_WriteCommand(LCD_RETURN_HOME);
-    HAL_Delay(2); // Home command needs extra time
-    return LCD_OK;
+    uint8_t value = state ? (hlcd->display_ctrl | LCD_BLINK_ON)
+                          : (hlcd->display_ctrl & ~LCD_BLINK_ON);
+    
+    return LCD_UpdateRegister(hlcd, LCD_DISPLAY_CONTROL, LCD_REG_DISPLAY,
+                              hlcd->display_ctrl, value);
 }
 
-/* Private helper functions --------------------------------------------------*/
-
 /**
-  * @brief  Writes nibble to LCD
-  * @param  data: 4-bit data
-  * @param  rs: Register select (0 for command, 1 for data)
+  * @brief  Sets the entry mode (text direction and display shift)
+  * @note   Nothing is sent if the mode is already set. In framebuffer mode
+  *         only LCD_ENTRY_LEFT without shift is supported: LCD_Flush
+  *         relies on the address counter moving right.
+  * @param  hlcd: LCD handle
+  * @param  mode: LCD_ENTRY_LEFT or LCD_ENTRY_RIGHT, ORed with
+  *         LCD_ENTRY_SHIFT_INC or LCD_ENTRY_SHIFT_DEC
+  * @retval LCD_StatusTypeDef: Status of operation
   */
-static void LCD_WriteNibble(uint8_t data, uint8_t rs)
+LCD_StatusTypeDef LCDx_SetEntryMode(LCD_HandleTypeDef* hlcd, uint8_t mode)
 {
-    uint8_t packet = data;
-    
-    if (rs) {
-        packet |= LCD_RS;
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
     }
     
-    // Add backlight bit
-    packet |= LCD_BACKLIGHT;
+    mode &= LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_INC;
     
-    // Set enable bit high
-    packet |= LCD_EN;
-    HAL_I2C_Master_Transmit(hi2c_lcd, lcd_addr, &packet, 1, 10);
-    HAL_Delay(1);
+#if LCD_USE_FRAMEBUFFER
+    if (mode != LCD_ENTRY_LEFT) {
+        return LCD_ERROR;
+    }
+#endif
     
-    // Set enable bit low
-    packet &= ~LCD_EN;
-    HAL_I2C_Master_Transmit(hi2c_lcd, lcd_addr, &packet, 1, 10);
-    HAL_Delay(1);
+    return LCD_UpdateRegister(hlcd, LCD_ENTRY_MODE_SET, LCD_REG_ENTRY,
+                              hlcd->entry_mode, mode);
 }
 
 /**
-  * @brief  Writes byte to LCD
-  * @param  data: 8-bit data
-  * @param  rs: Register select (0 for command, 1 for data)
+  * @brief  Sets LCD I2C address
+  * @param  hlcd: LCD handle
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of operation
   */
-static void LCD_WriteByte(uint8_t data, uint8_t rs)
+LCD_StatusTypeDef LCDx_SetAddress(LCD_HandleTypeDef* hlcd, uint8_t address)
 {
-    // Send high nibble
-    LCD_WriteNibble(data & 0xF0, rs);
-    // Send low nibble
-    LCD_WriteNibble((data << 4) & 0xF0, rs);
+    if (hlcd == NULL || address == LCD_ADDR_AUTO) {
+        return LCD_ERROR;
+    }
+    
+    hlcd->addr = address;
+    return LCD_OK;
 }
 
 /**
-  * @brief  Writes command to LCD
-  * @param  cmd: Command byte
+  * @brief  Finds a PCF8574 (0x20-0x27) or PCF8574A (0x38-0x3F) backpack
+  * @note   Addresses already used by an initialized display on the same
+  *         bus are skipped, so repeated calls find one display after the
+  *         other. Takes about 2 ms at 100 kHz when nothing answers.
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: First address that answered (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: LCD_OK, or LCD_ERROR if none answered
   */
-static void LCD_WriteCommand(uint8_t cmd)
+LCD_StatusTypeDef LCD_DetectAddress(I2C_HandleTypeDef* hi2c, uint8_t* address)
 {
-    LCD_WriteByte(cmd, 0);
+    if (hi2c == NULL || address == NULL) {
+        return LCD_ERROR;
+    }
+    
+    return LCD_Probe(NULL, hi2c, address);
 }
 
 /**
-  * @brief  Writes data to LCD
-  * @param  data: Data byte
+  * @brief  Sets the display geometry of a handle
+  * @note   Row offsets follow the HD44780 layout: rows 2 and 3 continue
+  *         rows 0 and 1 at column 'cols' (0x14/0x54 on 20x4, 0x10/0x50 on
+  *         16x4). In framebuffer mode the shadow is blanked and the next
+  *         LCD_Flush rewrites every cell, clearing the glass.
+  * @param  hlcd: LCD handle
+  * @param  rows: Number of rows (1-LCD_ROWS)
+  * @param  cols: Number of columns (1-LCD_COLS)
+  * @retval LCD_StatusTypeDef: Status of operation
   */
-static void LCD_WriteData(uint8_t data)
+LCD_StatusTypeDef LCDx_SetGeometry(LCD_HandleTypeDef* hlcd, uint8_t rows, uint8_t cols)
 {
-    LCD_WriteByte(data, 1);
+#if LCD_FIXED_GEOMETRY
+    if (hlcd == NULL || rows != LCD_ROWS || cols != LCD_COLS) {
+        return LCD_ERROR;
+    }
+#else
+    if (hlcd == NULL || rows == 0 || rows > LCD_ROWS || rows > 4 ||
+        cols == 0 || cols > LCD_COLS || (rows > 2 && cols > 20)) {
+        return LCD_ERROR;
+    }
+    
+    hlcd->rows = rows;
+    hlcd->cols = cols;
+    for (uint8_t row = 0; row < rows; row++) {
+        hlcd->row_offsets[row] = LCD_ROW_ADDR(row, cols);
+    }
+#endif
+    
+#if LCD_USE_FRAMEBUFFER
+    // Blank shadow; what the glass shows is not known, so the next flush
+    // rewrites every row in full
+    memset(hlcd->fb, ' ', sizeof(hlcd->fb));
+    memset(hlcd->fb_sent, ' ', sizeof(hlcd->fb_sent));
+    hlcd->fb_dirty = 0;
+    hlcd->fb_repaint = 0xFF;
+    hlcd->fb_row = 0;
+    hlcd->fb_col = 0;
+#endif
+    
+    return LCD_OK;
 }
 
 /**
-  * @brief  Sends pulse to enable pin
-  * @param  data: Data to send
+  * @brief  Stops using a handle
+  * @note   Queued traffic that has not been sent is dropped. Call only when
+  *         no asynchronous transfer of this handle is running.
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
   */
-static void LCD_PulseEnable(uint8_t data)
+LCD_StatusTypeDef LCDx_DeInit(LCD_HandleTypeDef* hlcd)
 {
-    HAL_I2C_Master_Transmit(hi2c_lcd, lcd_addr, &data, 1, 10);
-    HAL_Delay(1);
-    
-    data |= LCD_EN;
-    HAL_I2C_Master_Transmit(hi2c_lcd, lcd_addr, &data, 1, 10);
-    HAL_Delay(1);
+    LCD_HandleTypeDef** link = &lcd_handles;
     
-    data &= ~LCD_EN;
-    HAL_I2C_Master_Transmit(hi2c_lcd, lcd_addr, &data, 1, 10);
-    HAL_Delay(1);
-}
\ No newline at end of file
+    if (hlcd == NULL) {
+        return LCD_ERROR;
+    }
+    
+    if (hlcd->transport != NULL && hlcd->tx_inflight != 0) {
+        return LCD_BUSY;
+    }
+    
+    hlcd->transport = NULL;
+    while (*link != NULL) {
+        if (*link == hlcd) {
+            *link = hlcd->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    
+    return LCD_OK;
+}
+
+/**
+  * @brief  Scrolls display left
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ScrollLeft(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    return LCD_WriteCommand(hlcd, LCD_CURSOR_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_LEFT);
+}
+
+/**
+  * @brief  Scrolls display right
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ScrollRight(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    return LCD_WriteCommand(hlcd, LCD_CURSOR_SHIFT | LCD_DISPLAY_MOVE | LCD_MOVE_RIGHT);
+}
+
+/**
+  * @brief  Returns cursor to home position
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Home(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+#if LCD_USE_FRAMEBUFFER
+    hlcd->fb_row = 0;
+    hlcd->fb_col = 0;
+#endif
+    
+    // Still sent: also undoes any display shift
+    LCD_WriteByte(hlcd, LCD_RETURN_HOME, 0);
+    LCD_EncodeReady(hlcd, LCD_CLEAR_WAIT_US); // Home command needs extra time
+    return LCD_FlushTx(hlcd);
+}
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Sends the framebuffer cells that differ from what the LCD shows
+  * @note   Rows are committed one at a time. If the transmit queue is full,
+  *         LCD_BUSY is returned and the remaining rows stay dirty; LCD_Process
+  *         (and so LCD_WaitIdle) queues them as the queue drains.
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Flush(LCD_HandleTypeDef* hlcd)
+{
+    LCD_StatusTypeDef status = LCD_OK;
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    LCD_FbPlan(hlcd, 1, &status);
+    hlcd->fb_pending = (status == LCD_BUSY);
+    return status;
+}
+
+/**
+  * @brief  Returns the cost of the next LCD_Flush without sending anything
+  * @note   Leaves the framebuffer and its dirty rows untouched
+  * @param  hlcd: LCD handle
+  * @retval Number of expander bytes LCD_Flush would queue (waits excluded)
+  */
+uint16_t LCDx_FlushPlan(LCD_HandleTypeDef* hlcd)
+{
+    return LCD_FbPlan(hlcd, 0, NULL) * LCD_BYTE_WIRE_COST;
+}
+#endif
+
+/**
+  * @brief  Checks whether all queued LCD traffic has been sent
+  * @param  hlcd: LCD handle
+  * @retval 1 if the transmit queue is empty, 0 otherwise
+  */
+uint8_t LCDx_IsIdle(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL) {
+        return 1;
+    }
+    
+#if LCD_USE_FRAMEBUFFER
+    if (hlcd->fb_pending) {
+        return 0;  // Rest of a flush still to be queued
+    }
+#endif
+    
+    return (hlcd->tx_tail == hlcd->tx_head) && (hlcd->tx_inflight == 0);
+}
+
+/**
+  * @brief  Waits until all queued LCD traffic has been sent
+  * @param  hlcd: LCD handle
+  * @param  timeout: Timeout in milliseconds
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_TIMEOUT or the first transfer error
+  */
+LCD_StatusTypeDef LCDx_WaitIdle(LCD_HandleTypeDef* hlcd, uint32_t timeout)
+{
+    uint32_t start = HAL_GetTick();
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    while (!LCDx_IsIdle(hlcd)) {
+        LCD_Process();
+        if ((HAL_GetTick() - start) > timeout) {
+            return LCD_TIMEOUT;
+        }
+    }
+    
+    return LCD_FlushTx(hlcd);
+}
+
+/**
+  * @brief  Reads the HD44780 busy flag and address counter
+  * @note   Needs a transport with read and the LCD RW pin wired to the
+  *         PCF8574 (P1). Queued traffic is sent first.
+  * @param  hlcd: LCD handle
+  * @param  status: Busy flag (bit 7) and address counter (bits 0-6)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadStatus(LCD_HandleTypeDef* hlcd, uint8_t* status)
+{
+    LCD_StatusTypeDef result;
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    if (status == NULL || hlcd->transport->read == NULL) {
+        return LCD_ERROR;
+    }
+    
+    result = LCDx_WaitIdle(hlcd, LCD_INIT_TIMEOUT_MS);
+    if (result != LCD_OK) {
+        return result;
+    }
+    
+    if (hlcd->ctx == lcd_bus_owner) {
+        return LCD_BUSY;  // Reserved with LCD_BusAcquire
+    }
+    
+    return LCD_ReadBytes(hlcd, 0, status, 1);
+}
+
+/**
+  * @brief  Reads the characters of one row back from DDRAM
+  * @note   Needs the LCD RW pin on P1. Costs about 1 ms per character at
+  *         100 kHz (four transactions each).
+  * @param  hlcd: LCD handle
+  * @param  row: Row number
+  * @param  buf: Receives one byte per column
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadRow(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t* buf)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    if (buf == NULL || row >= LCD_GEO_ROWS(hlcd)) {
+        return LCD_ERROR;
+    }
+    
+    return LCD_ReadRam(hlcd, LCD_SET_DDRAM_ADDR | LCD_GEO_OFFSET(hlcd, row), buf,
+                       LCD_GEO_COLS(hlcd));
+}
+
+/**
+  * @brief  Reads a custom character pattern back from CGRAM
+  * @param  hlcd: LCD handle
+  * @param  location: Character location (0-7)
+  * @param  charmap: Receives 8 rows of 5 bits
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadChar(LCD_HandleTypeDef* hlcd, uint8_t location, uint8_t charmap[])
+{
+    LCD_StatusTypeDef status;
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    if (charmap == NULL) {
+        return LCD_ERROR;
+    }
+    
+    status = LCD_ReadRam(hlcd, LCD_SET_CGRAM_ADDR | ((location & 0x7) << 3), charmap, 8);
+    for (uint8_t i = 0; i < 8; i++) {
+        charmap[i] &= 0x1F;  // Upper bits of CGRAM are undefined
+    }
+    
+    return status;
+}
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Loads the framebuffer with what the LCD shows
+  * @note   Replaces the framebuffer contents. Afterwards LCDx_Flush only
+  *         sends cells drawn since, e.g. after LCDx_InitWarm.
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadBack(LCD_HandleTypeDef* hlcd)
+{
+    LCD_StatusTypeDef status;
+    
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    for (uint8_t row = 0; row < LCD_GEO_ROWS(hlcd); row++) {
+        status = LCDx_ReadRow(hlcd, row, hlcd->fb_sent[row]);
+        if (status != LCD_OK) {
+            return status;
+        }
+        memcpy(hlcd->fb[row], hlcd->fb_sent[row], LCD_GEO_COLS(hlcd));
+        hlcd->fb_dirty &= ~(1 << row);
+        hlcd->fb_repaint &= ~(1 << row);
+    }
+    
+    return LCD_OK;
+}
+#endif
+
+/**
+  * @brief  Advances the asynchronous transmit queues of all displays
+  * @note   Call from the main loop when using an asynchronous transport
+  */
+void LCD_Process(void)
+{
+    for (LCD_HandleTypeDef* h = lcd_handles; h != NULL; h = h->next) {
+        LCDx_Process(h);
+    }
+}
+
+/**
+  * @brief  Advances the asynchronous transmit queue of one display
+  * @note   Runs the power-on sequence of LCDx_InitStart, polls transports
+  *         that have no completion interrupt, retries a transfer that found
+  *         the bus busy with another device and, once the queue is empty,
+  *         queues the rows a full LCD_Flush could not.
+  * @param  hlcd: LCD handle
+  */
+void LCDx_Process(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return;
+    }
+    
+    if (hlcd->init_step != LCD_INIT_DONE) {
+        LCD_InitAdvance(hlcd);
+        if (hlcd->init_step == LCD_INIT_FAILED) {
+            hlcd->transport = NULL;  // Drop what was queued
+        }
+        return;
+    }
+    
+    if (hlcd->tx_inflight != 0 && hlcd->transport->poll != NULL) {
+        LCD_StatusTypeDef status;
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        
+        // Re-check: the completion interrupt may have beaten us to it
+        if (hlcd->tx_inflight != 0) {
+            status = hlcd->transport->poll(hlcd->ctx);
+            if (status != LCD_BUSY) {
+                LCDx_TransportDone(hlcd, status);
+            }
+        }
+        
+        __set_PRIMASK(primask);
+    }
+    
+#if LCD_USE_FRAMEBUFFER
+    if (hlcd->fb_pending && hlcd->tx_tail == hlcd->tx_head && hlcd->tx_inflight == 0) {
+        LCD_StatusTypeDef status = LCD_OK;
+        
+        LCD_FbPlan(hlcd, 1, &status);
+        hlcd->fb_pending = (status == LCD_BUSY);
+    }
+#endif
+    
+    LCD_Kick(hlcd);
+}
+
+/**
+  * @brief  Reports the end of a submitted transfer (asynchronous transports)
+  * @note   May be called from interrupt context. A failed chunk is dropped
+  *         and the error is reported by the next API call. The bus is then
+  *         offered to the other displays on it before this one again.
+  * @param  hlcd: LCD handle
+  * @param  status: LCD_OK, or the error the transfer ended with
+  */
+void LCDx_TransportDone(LCD_HandleTypeDef* hlcd, LCD_StatusTypeDef status)
+{
+    if (hlcd == NULL || hlcd->tx_inflight == 0) {
+        return;
+    }
+    
+    LCD_LatchStatus(hlcd, status);
+    hlcd->tx_tail = (hlcd->tx_tail + hlcd->tx_inflight) % LCD_TX_BUFFER_SIZE;
+    hlcd->tx_inflight = 0;
+    LCD_KickBus(hlcd);
+}
+
+/**
+  * @brief  Reserves an I2C bus shared with the displays for another device
+  * @note   Waits for the running display chunk (at most LCD_BUS_MAX_HOLD_US)
+  *         and keeps new display transfers off the bus until LCD_BusRelease.
+  *         One bus can be reserved at a time.
+  * @param  ctx: Transport context of the bus (e.g. &hi2c1)
+  * @param  timeout: Timeout in milliseconds
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_BUSY if another bus is reserved,
+  *         or LCD_TIMEOUT
+  */
+LCD_StatusTypeDef LCD_BusAcquire(void* ctx, uint32_t timeout)
+{
+    uint32_t start = HAL_GetTick();
+    
+    if (lcd_bus_owner != NULL && lcd_bus_owner != ctx) {
+        return LCD_BUSY;
+    }
+    
+    // From here on LCD_Kick starts nothing new on this bus
+    lcd_bus_owner = ctx;
+    
+    while (LCD_FindInflight(ctx) != NULL) {
+        LCD_Process();
+        if ((HAL_GetTick() - start) > timeout) {
+            LCD_BusRelease(ctx);
+            return LCD_TIMEOUT;
+        }
+    }
+    
+    return LCD_OK;
+}
+
+/**
+  * @brief  Ends a reservation made with LCD_BusAcquire
+  * @param  ctx: Transport context of the bus
+  */
+void LCD_BusRelease(void* ctx)
+{
+    if (lcd_bus_owner != ctx) {
+        return;
+    }
+    
+    lcd_bus_owner = NULL;
+    
+    // Restart whatever queued up meanwhile
+    for (LCD_HandleTypeDef* h = lcd_handles; h != NULL; h = h->next) {
+        if (h->ctx == ctx) {
+            LCD_Kick(h);
+        }
+    }
+}
+
+/**
+  * @brief  I2C transmit complete handler for the HAL DMA/IT transports
+  * @note   Call from HAL_I2C_MasterTxCpltCallback when
+  *         LCD_DEFINE_HAL_CALLBACKS is 0
+  * @param  hi2c: Pointer to I2C handle that completed
+  */
+void LCD_TxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+    LCD_HandleTypeDef* hlcd = LCD_FindInflight(hi2c);
+    
+    if (hlcd != NULL) {
+        LCDx_TransportDone(hlcd, LCD_OK);
+    }
+}
+
+/**
+  * @brief  I2C error handler for the HAL DMA/IT transports
+  * @note   Call from HAL_I2C_ErrorCallback when LCD_DEFINE_HAL_CALLBACKS is 0
+  * @param  hi2c: Pointer to I2C handle that failed
+  */
+void LCD_ErrorCallback(I2C_HandleTypeDef* hi2c)
+{
+    LCD_HandleTypeDef* hlcd = LCD_FindInflight(hi2c);
+    
+    if (hlcd != NULL) {
+        LCDx_TransportDone(hlcd, LCD_ERROR);
+    }
+}
+
+#if LCD_DEFINE_HAL_CALLBACKS
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef* hi2c)
+{
+    LCD_TxCpltCallback(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef* hi2c)
+{
+    LCD_ErrorCallback(hi2c);
+}
+#endif
+
+/**
+  * @brief  Busy-waits for a number of microseconds
+  * @note   Default implementation counts SysTick (no DWT on Cortex-M0+).
+  *         Override it if a hardware timer is available.
+  * @param  us: Microseconds to wait
+  */
+__weak void LCD_DelayUs(uint32_t us)
+{
+    uint32_t ticks_per_us = SystemCoreClock / 1000000U;
+    uint32_t reload = SysTick->LOAD + 1U;
+    uint32_t target = us * ticks_per_us;
+    uint32_t elapsed = 0;
+    uint32_t last = SysTick->VAL;
+    
+    while (elapsed < target) {
+        uint32_t now = SysTick->VAL;
+        // SysTick counts down and wraps to LOAD
+        elapsed += (last >= now) ? (last - now) : (last + reload - now);
+        last = now;
+    }
+}
+
+/* Single-display API --------------------------------------------------------*/
+// Existing single-display calls: each one forwards to its LCDx_ counterpart
+// on a driver-owned default handle.
+
+/**
+  * @brief  Initializes the default LCD with associated I2C handle
+  * @param  hi2c: Pointer to I2C handle
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCD_Init(I2C_HandleTypeDef* hi2c)
+{
+    // Probed on the first call only, then cached
+    if (lcd_default_addr == LCD_ADDR_AUTO && hi2c != NULL &&
+        LCD_Probe(&lcd_default, hi2c, &lcd_default_addr) != LCD_OK) {
+        return LCD_ERROR;
+    }
+    
+    return LCDx_Init(&lcd_default, hi2c, lcd_default_addr);
+}
+
+/**
+  * @brief  Initializes the default LCD over any byte transport
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCD_InitTransport(const LCD_TransportTypeDef* transport, void* ctx)
+{
+    return LCDx_InitTransport(&lcd_default, transport, ctx, lcd_default_addr);
+}
+
+/**
+  * @brief  Starts initializing the default LCD; see LCDx_InitTransportStart
+  * @param  hi2c: Pointer to I2C handle
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCD_InitStart(I2C_HandleTypeDef* hi2c)
+{
+    // Probed on the first call only, then cached
+    if (lcd_default_addr == LCD_ADDR_AUTO && hi2c != NULL &&
+        LCD_Probe(&lcd_default, hi2c, &lcd_default_addr) != LCD_OK) {
+        return LCD_ERROR;
+    }
+    
+    return LCDx_InitStart(&lcd_default, hi2c, lcd_default_addr);
+}
+
+/**
+  * @brief  Reports whether the default LCD is ready
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_BUSY or LCD_ERROR
+  */
+LCD_StatusTypeDef LCD_InitStatus(void)
+{
+    return LCDx_InitStatus(&lcd_default);
+}
+
+/**
+  * @brief  Attaches to the default LCD without clearing it if it is still
+  *         set up; see LCDx_InitWarmTransport
+  * @param  hi2c: Pointer to I2C handle
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCD_InitWarm(I2C_HandleTypeDef* hi2c)
+{
+    // Probed on the first call only, then cached
+    if (lcd_default_addr == LCD_ADDR_AUTO && hi2c != NULL &&
+        LCD_Probe(&lcd_default, hi2c, &lcd_default_addr) != LCD_OK) {
+        return LCD_ERROR;
+    }
+    
+    return LCDx_InitWarm(&lcd_default, hi2c, lcd_default_addr);
+}
+
+/**
+  * @brief  Sets the I2C address of the default LCD
+  * @note   Kept for existing code; with several displays use one handle
+  *         per display instead of switching the address
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_SetAddress(uint8_t address)
+{
+    lcd_default_addr = address;
+    
+    if (address == LCD_ADDR_AUTO) {
+        return LCD_OK;  // Probed by the next LCD_Init
+    }
+    
+    return LCDx_SetAddress(&lcd_default, address);
+}
+
+LCD_StatusTypeDef LCD_Clear(void)
+{
+    return LCDx_Clear(&lcd_default);
+}
+
+LCD_StatusTypeDef LCD_SetCursor(uint8_t row, uint8_t col)
+{
+    return LCDx_SetCursor(&lcd_default, row, col);
+}
+
+LCD_StatusTypeDef LCD_PrintString(const char* str)
+{
+    return LCDx_PrintString(&lcd_default, str);
+}
+
+LCD_StatusTypeDef LCD_PrintInt(int32_t num)
+{
+    return LCDx_PrintInt(&lcd_default, num);
+}
+
+LCD_StatusTypeDef LCD_PrintFloat(float num, uint8_t decimals)
+{
+    return LCDx_PrintFloat(&lcd_default, num, decimals);
+}
+
+LCD_StatusTypeDef LCD_Printf(const char* format, ...)
+{
+    LCD_StatusTypeDef status;
+    va_list args;
+    
+    va_start(args, format);
+    status = LCD_VPrintf(&lcd_default, format, args);
+    va_end(args);
+    
+    return status;
+}
+
+LCD_StatusTypeDef LCD_FieldInit(LCD_FieldTypeDef* field, uint8_t row, uint8_t col,
+                                uint8_t width, LCD_AlignTypeDef align, char pad,
+                                uint8_t is_signed)
+{
+    return LCDx_FieldInit(&lcd_default, field, row, col, width, align, pad, is_signed);
+}
+
+LCD_StatusTypeDef LCD_FieldUpdate(LCD_FieldTypeDef* field, int32_t value)
+{
+    return LCDx_FieldUpdate(&lcd_default, field, value);
+}
+
+LCD_StatusTypeDef LCD_CreateChar(uint8_t location, uint8_t charmap[])
+{
+    return LCDx_CreateChar(&lcd_default, location, charmap);
+}
+
+LCD_StatusTypeDef LCD_WriteChar(uint8_t location)
+{
+    return LCDx_WriteChar(&lcd_default, location);
+}
+
+LCD_StatusTypeDef LCD_Display(uint8_t state)
+{
+    return LCDx_Display(&lcd_default, state);
+}
+
+LCD_StatusTypeDef LCD_Cursor(uint8_t state)
+{
+    return LCDx_Cursor(&lcd_default, state);
+}
+
+LCD_StatusTypeDef LCD_Blink(uint8_t state)
+{
+    return LCDx_Blink(&lcd_default, state);
+}
+
+LCD_StatusTypeDef LCD_SetEntryMode(uint8_t mode)
+{
+    return LCDx_SetEntryMode(&lcd_default, mode);
+}
+
+LCD_StatusTypeDef LCD_ScrollLeft(void)
+{
+    return LCDx_ScrollLeft(&lcd_default);
+}
+
+LCD_StatusTypeDef LCD_ScrollRight(void)
+{
+    return LCDx_ScrollRight(&lcd_default);
+}
+
+LCD_StatusTypeDef LCD_Home(void)
+{
+    return LCDx_Home(&lcd_default);
+}
+
+#if LCD_USE_FRAMEBUFFER
+LCD_StatusTypeDef LCD_Flush(void)
+{
+    return LCDx_Flush(&lcd_default);
+}
+
+uint16_t LCD_FlushPlan(void)
+{
+    return LCDx_FlushPlan(&lcd_default);
+}
+#endif
+
+uint8_t LCD_IsIdle(void)
+{
+    return LCDx_IsIdle(&lcd_default);
+}
+
+LCD_StatusTypeDef LCD_WaitIdle(uint32_t timeout)
+{
+    return LCDx_WaitIdle(&lcd_default, timeout);
+}
+
+LCD_StatusTypeDef LCD_ReadStatus(uint8_t* status)
+{
+    return LCDx_ReadStatus(&lcd_default, status);
+}
+
+LCD_StatusTypeDef LCD_ReadRow(uint8_t row, uint8_t* buf)
+{
+    return LCDx_ReadRow(&lcd_default, row, buf);
+}
+
+LCD_StatusTypeDef LCD_ReadChar(uint8_t location, uint8_t charmap[])
+{
+    return LCDx_ReadChar(&lcd_default, location, charmap);
+}
+
+#if LCD_USE_FRAMEBUFFER
+LCD_StatusTypeDef LCD_ReadBack(void)
+{
+    return LCDx_ReadBack(&lcd_default);
+}
+#endif
+
+void LCD_TransportDone(LCD_StatusTypeDef status)
+{
+    LCDx_TransportDone(&lcd_default, status);
+}
+
+/* Private helper functions --------------------------------------------------*/
+
+/**
+  * @brief  Writes one character at the cursor (framebuffer or transmit queue)
+  * @param  data: Character code
+  */
+static void LCD_PutChar(LCD_HandleTypeDef* hlcd, uint8_t data)
+{
+#if LCD_USE_FRAMEBUFFER
+    LCD_FbWrite(hlcd, data);
+#else
+    LCD_WriteData(hlcd, data);
+#endif
+}
+
+/**
+  * @brief  Writes a padding character several times
+  * @param  c: Padding character
+  * @param  count: Number of characters (nothing if <= 0)
+  */
+static void LCD_PutPadding(LCD_HandleTypeDef* hlcd, uint8_t c, int16_t count)
+{
+    while (count-- > 0) {
+        LCD_PutChar(hlcd, c);
+    }
+}
+
+/**
+  * @brief  Writes an unsigned number with optional sign and padding
+  * @param  value: Magnitude
+  * @param  base: 10 or 16
+  * @param  upper: 1 for upper-case hex digits
+  * @param  sign: Sign character, or 0 for none
+  * @param  width: Minimum field width
+  * @param  flags: LCD_FMT_ZERO / LCD_FMT_LEFT
+  */
+static void LCD_EmitNumber(LCD_HandleTypeDef* hlcd, uint32_t value, uint8_t base,
+                           uint8_t upper, char sign, uint8_t width, uint8_t flags)
+{
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char reversed[10];
+    uint8_t len = 0;
+    
+    do {
+        reversed[len++] = digits[value % base];
+        value /= base;
+    } while (value != 0);
+    
+    int16_t pad = (int16_t)width - len - (sign ? 1 : 0);
+    
+    if (!(flags & (LCD_FMT_LEFT | LCD_FMT_ZERO))) {
+        LCD_PutPadding(hlcd, ' ', pad);
+    }
+    if (sign) {
+        LCD_PutChar(hlcd, sign);
+    }
+    if ((flags & LCD_FMT_ZERO) && !(flags & LCD_FMT_LEFT)) {
+        LCD_PutPadding(hlcd, '0', pad);
+    }
+    while (len > 0) {
+        LCD_PutChar(hlcd, reversed[--len]);
+    }
+    if (flags & LCD_FMT_LEFT) {
+        LCD_PutPadding(hlcd, ' ', pad);
+    }
+}
+
+/**
+  * @brief  Writes a float in fixed-point notation
+  * @note   Works on the IEEE-754 bits with integer arithmetic only (no FPU
+  *         on Cortex-M0+): the exact binary fraction is scaled by
+  *         10^decimals and rounded half away from zero. Magnitudes of 2^32
+  *         and above print as "ovf"; NaN and infinity as "nan" and "inf".
+  * @param  num: Float number
+  * @param  decimals: Number of decimal places (0-6)
+  * @param  width: Minimum field width
+  * @param  flags: LCD_FMT_ZERO / LCD_FMT_LEFT
+  */
+static void LCD_EmitFloat(LCD_HandleTypeDef* hlcd, float num, uint8_t decimals,
+                          uint8_t width, uint8_t flags)
+{
+    static const uint32_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    union { float f; uint32_t u; } bits;
+    const char* special = NULL;
+    uint32_t ipart = 0;
+    uint32_t fpart = 0;
+    
+    if (decimals > 6) decimals = 6;
+    
+    bits.f = num;
+    char sign = (bits.u >> 31) ? '-' : 0;
+    int16_t exponent = (bits.u >> 23) & 0xFF;
+    uint32_t mantissa = bits.u & 0x007FFFFF;
+    
+    if (exponent == 0xFF) {
+        special = mantissa ? "nan" : "inf";
+    } else {
+        // value = mantissa * 2^shift
+        if (exponent == 0) {
+            exponent = 1;  // Subnormal
+        } else {
+            mantissa |= 0x00800000;
+        }
+        int16_t shift = exponent - 150;
+        
+        if (shift > 8) {
+            special = "ovf";
+        } else if (shift >= 0) {
+            ipart = mantissa << shift;
+        } else if (shift > -64) {
+            uint8_t s = (uint8_t)-shift;
+            uint64_t frac = mantissa & ((1ULL << s) - 1);  // s > 24 keeps all
+            
+            ipart = (s < 32) ? (mantissa >> s) : 0;
+            fpart = (uint32_t)((frac * pow10[decimals] + (1ULL << (s - 1))) >> s);
+            
+            // Rounding carried into the integer part (e.g. 1.999 -> 2.00)
+            if (fpart >= pow10[decimals]) {
+                fpart -= pow10[decimals];
+                if (ipart == 0xFFFFFFFF) {
+                    special = "ovf";
+                }
+                ipart++;
+            }
+        }
+        // else: below 2^-63, rounds to zero at any supported precision
+    }
+    
+    if (special != NULL) {
+        int16_t pad = (int16_t)width - 3 - (sign ? 1 : 0);
+        if (!(flags & LCD_FMT_LEFT)) {
+            LCD_PutPadding(hlcd, ' ', pad);
+        }
+        if (sign) {
+            LCD_PutChar(hlcd, sign);
+        }
+        while (*special) {
+            LCD_PutChar(hlcd, *special++);
+        }
+        if (flags & LCD_FMT_LEFT) {
+            LCD_PutPadding(hlcd, ' ', pad);
+        }
+        return;
+    }
+    
+    // "-0.00" reads oddly on a display
+    if (ipart == 0 && fpart == 0) {
+        sign = 0;
+    }
+    
+    uint8_t frac_len = decimals ? decimals + 1 : 0;
+    uint8_t int_width = (width > frac_len) ? width - frac_len : 0;
+    
+    // Left alignment pads after the fraction, not after the integer part
+    LCD_EmitNumber(hlcd, ipart, 10, 0, sign, (flags & LCD_FMT_LEFT) ? 0 : int_width,
+                   flags & LCD_FMT_ZERO);
+    
+    if (decimals) {
+        LCD_PutChar(hlcd, '.');
+        LCD_EmitNumber(hlcd, fpart, 10, 0, 0, decimals, LCD_FMT_ZERO);
+    }
+    
+    if (flags & LCD_FMT_LEFT) {
+        uint8_t int_len = (sign ? 1 : 0);
+        do {
+            int_len++;
+            ipart /= 10;
+        } while (ipart != 0);
+        LCD_PutPadding(hlcd, ' ', (int16_t)int_width - int_len);
+    }
+}
+
+/**
+  * @brief  Formats into the framebuffer or transmit queue and sends it
+  * @param  format: Format string
+  * @param  args: Variable arguments
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+static LCD_StatusTypeDef LCD_VPrintf(LCD_HandleTypeDef* hlcd, const char* format, va_list args)
+{
+    if (hlcd == NULL || hlcd->transport == NULL) {
+        return LCD_NOT_INITIALIZED;
+    }
+    
+    if (format == NULL) {
+        return LCD_ERROR;
+    }
+    
+    LCD_Format(hlcd, format, args);
+    
+#if LCD_USE_FRAMEBUFFER
+    return LCD_OK;
+#else
+    return LCD_FlushTx(hlcd);
+#endif
+}
+
+/**
+  * @brief  Streams a printf-style format string to the LCD
+  * @param  format: Format string
+  * @param  args: Variable arguments
+  */
+static void LCD_Format(LCD_HandleTypeDef* hlcd, const char* format, va_list args)
+{
+    while (*format) {
+        uint8_t flags = 0;
+        uint8_t width = 0;
+        uint8_t precision = 6;  // %f default, as in printf
+        uint8_t is_long = 0;
+        
+        if (*format != '%') {
+            LCD_PutChar(hlcd, *format++);
+            continue;
+        }
+        format++;
+        
+        // Flags
+        for (;; format++) {
+            if (*format == '0') {
+                flags |= LCD_FMT_ZERO;
+            } else if (*format == '-') {
+                flags |= LCD_FMT_LEFT;
+            } else {
+                break;
+            }
+        }
+        
+        // Width and precision, clamped so "%300d" does not wrap around
+        while (*format >= '0' && *format <= '9') {
+            uint16_t next = width * 10 + (*format++ - '0');
+            width = (next > LCD_FMT_MAX_WIDTH) ? LCD_FMT_MAX_WIDTH : (uint8_t)next;
+        }
+        if (*format == '.') {
+            format++;
+            precision = 0;
+            while (*format >= '0' && *format <= '9') {
+                uint16_t next = precision * 10 + (*format++ - '0');
+                precision = (next > LCD_FMT_MAX_PRECISION) ? LCD_FMT_MAX_PRECISION : (uint8_t)next;
+            }
+        }
+        
+        // Length modifier: long is read as long (64 bits on some hosts) and
+        // narrowed to the 32 bits printed
+        if (*format == 'l') {
+            is_long = 1;
+            format++;
+        }
+        
+        switch (*format) {
+            case 'd':
+            case 'i': {
+                int32_t value = is_long ? (int32_t)va_arg(args, long) : va_arg(args, int);
+                uint32_t magnitude = (value < 0) ? 0U - (uint32_t)value : (uint32_t)value;
+                LCD_EmitNumber(hlcd, magnitude, 10, 0, (value < 0) ? '-' : 0, width, flags);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                uint32_t value = is_long ? (uint32_t)va_arg(args, unsigned long)
+                                         : va_arg(args, unsigned int);
+                LCD_EmitNumber(hlcd, value, (*format == 'u') ? 10 : 16, *format == 'X', 0,
+                               width, flags);
+                break;
+            }
+            case 'f':
+                LCD_EmitFloat(hlcd, (float)va_arg(args, double), precision, width, flags);
+                break;
+            case 'c':
+                LCD_PutPadding(hlcd, ' ', (flags & LCD_FMT_LEFT) ? 0 : (int16_t)width - 1);
+                LCD_PutChar(hlcd, (uint8_t)va_arg(args, int));
+                LCD_PutPadding(hlcd, ' ', (flags & LCD_FMT_LEFT) ? (int16_t)width - 1 : 0);
+                break;
+            case 's': {
+                const char* str = va_arg(args, const char*);
+                int16_t pad;
+                if (str == NULL) {
+                    str = "(null)";
+                }
+                pad = (int16_t)width - (int16_t)strlen(str);
+                if (!(flags & LCD_FMT_LEFT)) {
+                    LCD_PutPadding(hlcd, ' ', pad);
+                }
+                while (*str) {
+                    LCD_PutChar(hlcd, *str++);
+                }
+                if (flags & LCD_FMT_LEFT) {
+                    LCD_PutPadding(hlcd, ' ', pad);
+                }
+                break;
+            }
+            case '%':
+                LCD_PutChar(hlcd, '%');
+                break;
+            case '\0':
+                // Dangling '%' at the end of the format
+                return;
+            default:
+                // Unknown conversion: print it as-is
+                LCD_PutChar(hlcd, '%');
+                LCD_PutChar(hlcd, *format);
+                break;
+        }
+        format++;
+    }
+}
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Writes one character into the framebuffer at the cursor
+  * @note   Characters past the last column are dropped
+  * @param  data: Character code
+  */
+static void LCD_FbWrite(LCD_HandleTypeDef* hlcd, uint8_t data)
+{
+    if (hlcd->fb_col < LCD_GEO_COLS(hlcd)) {
+        uint8_t* cell = &hlcd->fb[hlcd->fb_row][hlcd->fb_col++];
+        
+        if (*cell != data) {
+            *cell = data;
+            hlcd->fb_dirty |= 1 << hlcd->fb_row;
+        }
+    }
+}
+
+/**
+  * @brief  XOR of one word (4 cells) of two framebuffer rows
+  * @param  a: First row
+  * @param  b: Second row
+  * @param  word: Word index
+  * @retval Bytes that differ are non-zero
+  */
+static uint32_t LCD_FbWordDiff(const uint8_t* a, const uint8_t* b, uint8_t word)
+{
+    uint32_t wa;
+    uint32_t wb;
+    
+    memcpy(&wa, &a[word * 4], sizeof(wa));
+    memcpy(&wb, &b[word * 4], sizeof(wb));
+    return wa ^ wb;
+}
+
+/**
+  * @brief  Finds the first and last cell of a row that differ from the LCD
+  * @note   Compares 4 cells per word. Cells past the last column are never
+  *         written, so the padding of the last word always matches. Cortex-M
+  *         is little-endian: the lowest byte of a word is the leftmost cell.
+  *         Words are loaded with memcpy, not through a uint32_t pointer, so
+  *         the byte rows are not accessed as another type; with the rows
+  *         aligned it compiles to a single load.
+  * @param  row: Row index
+  * @param  first: Receives the first differing column
+  * @param  last: Receives the last differing column
+  * @retval 1 if the row differs, 0 if it matches what was sent
+  */
+static uint8_t LCD_FbDiff(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t* first, uint8_t* last)
+{
+    const uint8_t* fb = hlcd->fb[row];
+    const uint8_t* sent = hlcd->fb_sent[row];
+    uint8_t words = (LCD_GEO_COLS(hlcd) + 3) / 4;
+    uint8_t lo = 0;
+    uint8_t hi = words - 1;
+    uint32_t diff;
+    
+    while ((diff = LCD_FbWordDiff(fb, sent, lo)) == 0) {
+        if (++lo == words) {
+            return 0;
+        }
+    }
+    *first = lo * 4 + ((diff & 0x000000FF) ? 0 : (diff & 0x0000FFFF) ? 1 :
+                       (diff & 0x00FFFFFF) ? 2 : 3);
+    
+    while ((diff = LCD_FbWordDiff(fb, sent, hi)) == 0) {
+        hi--;
+    }
+    *last = hi * 4 + ((diff & 0xFF000000) ? 3 : (diff & 0x00FF0000) ? 2 :
+                      (diff & 0x0000FF00) ? 1 : 0);
+    return 1;
+}
+
+/**
+  * @brief  Plans the cheapest command stream that brings the LCD up to date
+  * @note   A set-address command and a character both cost one LCD byte,
+  *         so a gap of one unchanged cell costs the same to rewrite as to
+  *         skip. It is rewritten: the run stays in data writes with no
+  *         command in between, and the plan stays a single run. Rows are
+  *         visited in DDRAM order, which also lets a run continue across
+  *         the row 0 -> row 2 wrap of 20x4 modules without re-addressing.
+  *         Only an emitting pass changes the handle.
+  * @param  emit: 0 to only count, 1 to encode and send
+  * @param  status: First failed row commit when emitting (may be NULL)
+  * @retval Number of LCD bytes (commands + characters) in the plan
+  */
+static uint16_t LCD_FbPlan(LCD_HandleTypeDef* hlcd, uint8_t emit, LCD_StatusTypeDef* status)
+{
+    uint8_t addr = hlcd->ac;  // Where the address counter points
+    uint8_t prev = 0x00;
+    uint16_t count = 0;
+    
+    if (((hlcd->fb_dirty | hlcd->fb_repaint) & ((1 << LCD_GEO_ROWS(hlcd)) - 1)) == 0) {
+        return 0;  // Nothing written since the last flush
+    }
+    
+    for (uint8_t i = 0; i < LCD_GEO_ROWS(hlcd); i++) {
+        // Next row in DDRAM order
+        uint8_t row = 0;
+        uint8_t best = 0xFF;
+        for (uint8_t r = 0; r < LCD_GEO_ROWS(hlcd); r++) {
+            uint8_t offset = LCD_GEO_OFFSET(hlcd, r);
+            if ((i == 0 || offset > prev) && offset <= best) {
+                best = offset;
+                row = r;
+            }
+        }
+        prev = best;
+        
+        uint8_t repaint = (hlcd->fb_repaint >> row) & 1;  // fb_sent not valid
+        uint8_t first = 0;
+        uint8_t last = LCD_GEO_COLS(hlcd) - 1;
+        
+        if (!repaint) {
+            if (!((hlcd->fb_dirty >> row) & 1)) {
+                continue;
+            }
+            if (!LCD_FbDiff(hlcd, row, &first, &last)) {
+                if (emit) {
+                    hlcd->fb_dirty &= ~(1 << row);  // Written back to what is shown
+                }
+                continue;
+            }
+        }
+        
+        for (uint8_t col = first; col <= last; col++) {
+            uint8_t target = LCD_GEO_OFFSET(hlcd, row) + col;
+            
+            if (!repaint && hlcd->fb[row][col] == hlcd->fb_sent[row][col]) {
+                continue;
+            }
+            
+            if (addr != LCD_ADDR_UNKNOWN && LCD_NEXT_ADDR(addr) == target &&
+                LCD_FbCellAt(hlcd, addr) != NULL) {
+                // One unchanged cell in between: rewrite it
+                if (emit) {
+                    LCD_WriteData(hlcd, *LCD_FbCellAt(hlcd, addr));
+                }
+                count++;
+            } else if (addr != target) {
+                if (emit) {
+                    LCD_WriteByte(hlcd, LCD_SET_DDRAM_ADDR | target, 0);
+                }
+                count++;
+            }
+            
+            if (emit) {
+                LCD_WriteData(hlcd, hlcd->fb[row][col]);
+            }
+            count++;
+            addr = LCD_NEXT_ADDR(target);
+        }
+        
+        if (emit) {
+            LCD_StatusTypeDef result = LCD_FlushTx(hlcd);
+            if (result != LCD_OK) {
+                // Row not (fully) sent: keep it dirty
+                if (status != NULL) {
+                    *status = result;
+                }
+                return count;
+            }
+            memcpy(hlcd->fb_sent[row], hlcd->fb[row], LCD_GEO_COLS(hlcd));
+            hlcd->fb_dirty &= ~(1 << row);
+            hlcd->fb_repaint &= ~(1 << row);
+        }
+    }
+    
+    return count;
+}
+
+/**
+  * @brief  Maps a DDRAM address to its framebuffer cell
+  * @param  addr: DDRAM address
+  * @retval Pointer to the cell, or NULL if the address is not visible
+  */
+static uint8_t* LCD_FbCellAt(LCD_HandleTypeDef* hlcd, uint8_t addr)
+{
+    for (uint8_t row = 0; row < LCD_GEO_ROWS(hlcd); row++) {
+        uint8_t offset = LCD_GEO_OFFSET(hlcd, row);
+        if (addr >= offset && addr < offset + LCD_GEO_COLS(hlcd)) {
+            return &hlcd->fb[row][addr - offset];
+        }
+    }
+    
+    return NULL;
+}
+#endif
+
+/**
+  * @brief  Probes the backpack addresses with HAL_I2C_IsDeviceReady
+  * @param  hlcd: Display being initialized (its own address is not
+  *         skipped), or NULL
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: First free address that answered (shifted)
+  * @retval LCD_StatusTypeDef: LCD_OK, or LCD_ERROR if none answered
+  */
+static LCD_StatusTypeDef LCD_Probe(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c,
+                                   uint8_t* address)
+{
+    for (uint8_t i = 0; i < sizeof(lcd_probe_addrs); i++) {
+        uint8_t candidate = lcd_probe_addrs[i] << 1;
+        LCD_HandleTypeDef* h;
+        
+        for (h = lcd_handles; h != NULL; h = h->next) {
+            if (h != hlcd && h->transport != NULL && h->ctx == hi2c && h->addr == candidate) {
+                break;  // Another display
+            }
+        }
+        
+        // One trial, short timeout: an empty address NACKs within one byte
+        if (h == NULL &&
+            HAL_I2C_IsDeviceReady(hi2c, candidate, 1, LCD_PROBE_TIMEOUT_MS) == HAL_OK) {
+            *address = candidate;
+            return LCD_OK;
+        }
+    }
+    
+    return LCD_ERROR;
+}
+
+/**
+  * @brief  Runs the power-on steps whose wait is over
+  * @note   Waits of up to LCD_INIT_SPIN_US are busy-waited, longer ones are
+  *         left to the next call. The steps are written directly, so the
+  *         transmit queue keeps whatever was drawn meanwhile; it is
+  *         committed behind the last step.
+  */
+static void LCD_InitAdvance(LCD_HandleTypeDef* hlcd)
+{
+    while (LCD_INIT_PENDING()) {
+        const LCD_InitStepTypeDef* step;
+        LCD_StatusTypeDef status;
+        uint32_t wait_us;
+        
+        if ((HAL_GetTick() - hlcd->init_tick) < hlcd->init_wait_ms) {
+            return;  // Datasheet wait still running
+        }
+        
+        if (hlcd->init_step >= LCD_INIT_STEPS) {
+            hlcd->init_step = LCD_INIT_DONE;
+            LCD_Commit(hlcd);
+            return;
+        }
+        
+        if (hlcd->ctx == lcd_bus_owner || LCD_FindInflight(hlcd->ctx) != NULL) {
+            return;  // Bus in use: retried from LCD_Process
+        }
+        
+        step = &lcd_init_steps[hlcd->init_step];
+        status = LCD_InitSend(hlcd, step);
+        if (status == LCD_BUSY) {
+            return;
+        }
+        if (status != LCD_OK) {
+            hlcd->init_step = LCD_INIT_FAILED;  // Nothing answered
+            return;
+        }
+        
+        wait_us = step->wait_us;
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+        // Conservative mode for slow clones: 1 ms per nibble on top
+        wait_us += step->nibble ? 1000 : 2000;
+#endif
+        
+        hlcd->init_step++;
+        hlcd->init_wait_ms = 0;
+        if (wait_us <= LCD_INIT_SPIN_US) {
+            LCD_DelayUs(wait_us);
+        } else {
+            // One extra tick: the first one may be about to elapse
+            hlcd->init_tick = HAL_GetTick();
+            hlcd->init_wait_ms = (uint8_t)((wait_us + 999) / 1000 + 1);
+        }
+    }
+}
+
+/**
+  * @brief  Writes one power-on step as its own transaction
+  * @param  step: Nibble or instruction to send
+  * @retval LCD_StatusTypeDef: Status of the transfer
+  */
+static LCD_StatusTypeDef LCD_InitSend(LCD_HandleTypeDef* hlcd, const LCD_InitStepTypeDef* step)
+{
+    uint8_t high = (step->data & 0xF0) | LCD_BACKLIGHT;
+    uint8_t low = ((step->data << 4) & 0xF0) | LCD_BACKLIGHT;
+    uint8_t packets[LCD_BYTE_WIRE_COST];
+    uint8_t len = 0;
+    
+    packets[len++] = high | LCD_EN;
+    packets[len++] = high;
+    if (!step->nibble) {
+        packets[len++] = low | LCD_EN;
+        packets[len++] = low;
+        while (len < LCD_BYTE_WIRE_COST) {
+            packets[len++] = LCD_IDLE_BYTE;
+        }
+    }
+    
+    return hlcd->transport->write(hlcd->ctx, hlcd->addr, packets, len);
+}
+
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+/**
+  * @brief  Appends one nibble (EN high, then EN low) to the transmit queue
+  * @note   The PCF8574 latches every byte of a multi-byte write, so each
+  *         byte on the bus is one pin update. One byte time (~90 us at
+  *         100 kHz) already covers the 450 ns EN pulse width
+  * @param  data: 4-bit data in the upper nibble
+  * @param  rs: Register select (0 for command, 1 for data)
+  */
+static void LCD_EncodeNibble(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs)
+{
+    uint8_t packet = (data & 0xF0) | LCD_BACKLIGHT;
+    
+    if (rs) {
+        packet |= LCD_RS;
+    }
+    
+    if (!LCD_Reserve(hlcd, 2)) {
+        return;
+    }
+    
+    LCD_Put(hlcd, packet | LCD_EN);
+    LCD_Put(hlcd, packet);
+    
+#if !LCD_USE_BUSY_FLAG
+    // Conservative mode for slow clones: 1 ms after every nibble
+    LCD_EncodeWait(hlcd, 1000);
+#endif
+}
+#endif
+
+/**
+  * @brief  Appends one byte (two nibbles) to the transmit queue
+  * @param  data: 8-bit data
+  * @param  rs: Register select (0 for command, 1 for data)
+  */
+static void LCD_WriteByte(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs)
+{
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+    uint8_t encoded[LCD_BYTE_WIRE_COST];
+    
+    // Keep both nibbles of a byte in the same transaction
+    LCD_PutBlock(hlcd, encoded, LCD_EncodeByte(encoded, data, rs));
+#else
+    if (!LCD_Reserve(hlcd, 4)) {
+        return;
+    }
+    
+    // Send high nibble
+    LCD_EncodeNibble(hlcd, data & 0xF0, rs);
+    // Send low nibble
+    LCD_EncodeNibble(hlcd, (data << 4) & 0xF0, rs);
+#endif
+    
+    LCD_Track(hlcd, data, rs);
+    
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY) && LCD_USE_BUSY_FLAG
+    // Slow clones: wait on the busy flag once per byte instead. After
+    // LCD_Track, so a fallback to timed waits can correct the counter
+    LCD_EncodeReady(hlcd, 2000);
+#endif
+}
+
+/**
+  * @brief  Follows the effect of a byte on the HD44780 registers
+  * @param  data: Byte sent
+  * @param  rs: Register select (0 for command, 1 for data)
+  */
+static void LCD_Track(LCD_HandleTypeDef* hlcd, uint8_t data, uint8_t rs)
+{
+    uint8_t increment = (hlcd->entry_mode & LCD_ENTRY_LEFT) != 0;
+    
+    if (rs) {
+        // A RAM write moves the counter of the RAM it went to
+        if (hlcd->stale & LCD_REG_ENTRY) {
+            hlcd->ac = LCD_ADDR_UNKNOWN;  // Direction not known
+            hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+        } else if (hlcd->ac != LCD_ADDR_UNKNOWN) {
+            hlcd->ac = increment ? LCD_NEXT_ADDR(hlcd->ac) : LCD_PREV_ADDR(hlcd->ac);
+        } else if (hlcd->cgram_ac != LCD_ADDR_UNKNOWN) {
+            hlcd->cgram_ac = (hlcd->cgram_ac + (increment ? 1 : 0x3F)) & 0x3F;
+        }
+    } else if (data & LCD_SET_DDRAM_ADDR) {
+        hlcd->ac = data & 0x7F;
+        hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+    } else if (data & LCD_SET_CGRAM_ADDR) {
+        hlcd->ac = LCD_ADDR_UNKNOWN;
+        hlcd->cgram_ac = data & 0x3F;
+    } else if (data & LCD_FUNCTION_SET) {
+        hlcd->function_set = data & (LCD_8BIT_MODE | LCD_2LINE | LCD_5x10DOTS);
+        hlcd->stale &= ~LCD_REG_FUNCTION;
+    } else if (data & LCD_CURSOR_SHIFT) {
+        // Display shifts keep the counter, cursor moves change it
+        if (!(data & LCD_DISPLAY_MOVE) && hlcd->ac != LCD_ADDR_UNKNOWN) {
+            hlcd->ac = (data & LCD_MOVE_RIGHT) ? LCD_NEXT_ADDR(hlcd->ac) : LCD_PREV_ADDR(hlcd->ac);
+        }
+        if (!(data & LCD_DISPLAY_MOVE)) {
+            hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+        }
+    } else if (data & LCD_DISPLAY_CONTROL) {
+        hlcd->display_ctrl = data & (LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_ON);
+        hlcd->stale &= ~LCD_REG_DISPLAY;
+    } else if (data & LCD_ENTRY_MODE_SET) {
+        hlcd->entry_mode = data & (LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_INC);
+        hlcd->stale &= ~LCD_REG_ENTRY;
+    } else if (data & (LCD_CLEAR_DISPLAY | LCD_RETURN_HOME)) {
+        // Clear display also resets to increment mode
+        hlcd->ac = 0x00;
+        hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+        if (data == LCD_CLEAR_DISPLAY) {
+            hlcd->entry_mode |= LCD_ENTRY_LEFT;
+        }
+    }
+}
+
+/**
+  * @brief  Writes command to LCD
+  * @param  cmd: Command byte
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+static LCD_StatusTypeDef LCD_WriteCommand(LCD_HandleTypeDef* hlcd, uint8_t cmd)
+{
+    LCD_WriteByte(hlcd, cmd, 0);
+    return LCD_FlushTx(hlcd);
+}
+
+/**
+  * @brief  Writes a register from its shadow, skipping unchanged values
+  * @param  cmd: Register command (e.g. LCD_DISPLAY_CONTROL)
+  * @param  reg: LCD_REG_ bit of the register
+  * @param  shadow: Value as last sent
+  * @param  value: Requested value (without the command bits)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+static LCD_StatusTypeDef LCD_UpdateRegister(LCD_HandleTypeDef* hlcd, uint8_t cmd, uint8_t reg,
+                                            uint8_t shadow, uint8_t value)
+{
+    if (value == shadow && !(hlcd->stale & reg)) {
+        return LCD_FlushTx(hlcd);
+    }
+    
+    return LCD_WriteCommand(hlcd, cmd | value);
+}
+
+/**
+  * @brief  Sends the registers marked stale from their shadows
+  * @note   After a failed transfer or a warm attach. Without it a stale
+  *         entry mode would keep the address counter untracked for good.
+  */
+static void LCD_Resync(LCD_HandleTypeDef* hlcd)
+{
+    uint8_t stale = hlcd->stale;
+    
+    hlcd->stale = 0;  // Before writing: LCD_Reserve calls back into here
+    if (stale & LCD_REG_FUNCTION) {
+        LCD_WriteByte(hlcd, LCD_FUNCTION_SET | hlcd->function_set, 0);
+    }
+    if (stale & LCD_REG_ENTRY) {
+        LCD_WriteByte(hlcd, LCD_ENTRY_MODE_SET | hlcd->entry_mode, 0);
+    }
+    if (stale & LCD_REG_DISPLAY) {
+        LCD_WriteByte(hlcd, LCD_DISPLAY_CONTROL | hlcd->display_ctrl, 0);
+    }
+}
+
+/**
+  * @brief  Queues data byte for the LCD
+  * @param  data: Data byte
+  */
+static void LCD_WriteData(LCD_HandleTypeDef* hlcd, uint8_t data)
+{
+    LCD_WriteByte(hlcd, data, 1);
+}
+
+/**
+  * @brief  Inserts a wait before the next queued byte
+  * @note   The blocking transport sends what is queued and sleeps. The
+  *         asynchronous transports instead queue idle bytes whose wire time
+  *         covers the wait, so the CPU never has to come back for it. So
+  *         does the blocking transport while the power-on sequence runs.
+  * @param  us: Minimum wait in microseconds
+  */
+static void LCD_EncodeWait(LCD_HandleTypeDef* hlcd, uint32_t us)
+{
+    if (!LCD_IS_ASYNC() && !LCD_INIT_PENDING()) {
+        LCD_Commit(hlcd);
+        LCD_DelayUs(us);
+        return;
+    }
+    
+    uint16_t count = (uint16_t)((us * 1000ULL + LCD_BYTE_TIME_NS - 1) / LCD_BYTE_TIME_NS);
+    
+    if (!LCD_Reserve(hlcd, count)) {
+        return;
+    }
+    
+    while (count--) {
+        LCD_Put(hlcd, LCD_IDLE_BYTE);
+    }
+}
+
+/**
+  * @brief  Inserts a wait for the HD44780 to finish the last instruction
+  * @note   With LCD_USE_BUSY_FLAG the blocking transport polls the busy
+  *         flag and goes on as soon as it clears. If a read fails, the
+  *         timed wait follows. A flag still set after twice the datasheet
+  *         time means RW is not wired: every poll was written as
+  *         instruction 0xFF (Set DDRAM 0x7F), so the address counter is
+  *         set back to where it was before the polls (DDRAM or CGRAM) and
+  *         the display keeps to timed waits. The display shift is not
+  *         touched by those writes.
+  * @param  us: Datasheet wait in microseconds
+  */
+static void LCD_EncodeReady(LCD_HandleTypeDef* hlcd, uint32_t us)
+{
+#if LCD_USE_BUSY_FLAG
+    if (!LCD_IS_ASYNC() && !LCD_INIT_PENDING() && hlcd->busy_flag) {
+        uint32_t start = HAL_GetTick();
+        uint8_t ac = hlcd->ac;              // Counters as the polls find them
+        uint8_t cgram_ac = hlcd->cgram_ac;
+        uint8_t status;
+        
+        LCD_Commit(hlcd);
+        
+        while (LCD_ReadBytes(hlcd, 0, &status, 1) == LCD_OK) {
+            if (!(status & LCD_BUSY_FLAG)) {
+                return;
+            }
+            if ((HAL_GetTick() - start) > (2 * us) / 1000 + 1) {
+                // RW tied low: every poll reached the LCD as 0xFF (Set DDRAM
+                // 0x7F). Point the address counter back where it was
+                hlcd->busy_flag = 0;
+                LCD_EncodeWait(hlcd, us);
+                if (ac != LCD_ADDR_UNKNOWN) {
+                    LCD_WriteByte(hlcd, LCD_SET_DDRAM_ADDR | ac, 0);
+                } else if (cgram_ac != LCD_ADDR_UNKNOWN) {
+                    LCD_WriteByte(hlcd, LCD_SET_CGRAM_ADDR | cgram_ac, 0);
+                }
+                break;
+            }
+        }
+    }
+#endif
+    
+    LCD_EncodeWait(hlcd, us);
+}
+
+/**
+  * @brief  Reads bytes from the HD44780 (RW high, two nibbles each)
+  * @note   The queue must be empty. D4-D7 are written high so the PCF8574
+  *         quasi-bidirectional pins let the LCD drive them. Every nibble
+  *         is clocked, even after an error, so the 4-bit interface stays in
+  *         step. The EN falling edge of one nibble is the first byte of the
+  *         write that raises EN for the next.
+  * @param  rs: 0 for busy flag and address counter, 1 for RAM data
+  * @param  data: Bytes read
+  * @param  len: Number of bytes
+  * @retval LCD_StatusTypeDef: Status of the transfers
+  */
+static LCD_StatusTypeDef LCD_ReadBytes(LCD_HandleTypeDef* hlcd, uint8_t rs, uint8_t* data,
+                                       uint8_t len)
+{
+    uint8_t packet = 0xF0 | LCD_BACKLIGHT | LCD_RW | (rs ? LCD_RS : 0);
+    uint8_t strobe[2] = { packet, packet | LCD_EN };
+    LCD_StatusTypeDef status = LCD_OK;
+    LCD_StatusTypeDef result;
+    
+    if (hlcd->transport->read == NULL) {
+        return LCD_ERROR;
+    }
+    
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t nibble[2] = { 0, 0 };
+        
+        for (uint8_t n = 0; n < 2; n++) {
+            // EN high: the LCD drives D4-D7 until EN falls
+            result = hlcd->transport->write(hlcd->ctx, hlcd->addr, strobe, 2);
+            if (result == LCD_OK) {
+                result = hlcd->transport->read(hlcd->ctx, hlcd->addr, &nibble[n], 1);
+            }
+            if (status == LCD_OK) {
+                status = result;
+            }
+        }
+        
+        data[i] = (nibble[0] & 0xF0) | (nibble[1] >> 4);
+    }
+    
+    // EN low ends the read; RW stays high until the next write
+    result = hlcd->transport->write(hlcd->ctx, hlcd->addr, strobe, 1);
+    if (status == LCD_OK) {
+        status = result;
+    }
+    
+    return status;
+}
+
+/**
+  * @brief  Reads DDRAM or CGRAM from an address on
+  * @note   Sends what is queued first. The address counter moves as for
+  *         writes, so the shadow follows it.
+  * @param  cmd: Set-address command (LCD_SET_DDRAM_ADDR or LCD_SET_CGRAM_ADDR)
+  * @param  data: Bytes read
+  * @param  len: Number of bytes
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+static LCD_StatusTypeDef LCD_ReadRam(LCD_HandleTypeDef* hlcd, uint8_t cmd, uint8_t* data,
+                                     uint8_t len)
+{
+    LCD_StatusTypeDef status;
+    
+    if (hlcd->transport->read == NULL) {
+        return LCD_ERROR;
+    }
+    
+    // A RAM read must follow a set-address command
+    LCD_WriteByte(hlcd, cmd, 0);
+    status = LCD_FlushTx(hlcd);
+    if (status == LCD_OK) {
+        status = LCDx_WaitIdle(hlcd, LCD_INIT_TIMEOUT_MS);
+    }
+    if (status != LCD_OK) {
+        return status;
+    }
+    
+    if (hlcd->ctx == lcd_bus_owner) {
+        return LCD_BUSY;  // Reserved with LCD_BusAcquire
+    }
+    
+    status = LCD_ReadBytes(hlcd, 1, data, len);
+    for (uint8_t i = 0; i < len; i++) {
+        LCD_Track(hlcd, data[i], 1);
+    }
+    
+    if (status != LCD_OK) {
+        hlcd->ac = LCD_ADDR_UNKNOWN;
+        hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+    }
+    
+    return status;
+}
+
+/**
+  * @brief  Makes room for bytes in the transmit queue
+  * @note   The blocking transport drains the queue to make room, first
+  *         finishing the power-on sequence if it still runs. The
+  *         asynchronous transports never wait: the whole operation is
+  *         dropped and LCD_FlushTx reports LCD_BUSY. Stale registers are
+  *         queued first (LCD_Resync).
+  * @param  count: Number of bytes about to be written
+  * @retval 1 if the bytes fit, 0 otherwise
+  */
+static uint8_t LCD_Reserve(LCD_HandleTypeDef* hlcd, uint16_t count)
+{
+    if (hlcd->tx_overflow) {
+        return 0;
+    }
+    
+    // Registers not known to match go out before anything else
+    if (hlcd->stale) {
+        LCD_Resync(hlcd);
+    }
+    
+    uint16_t used = (hlcd->tx_wr + LCD_TX_BUFFER_SIZE - hlcd->tx_tail) % LCD_TX_BUFFER_SIZE;
+    
+    if (used + count < LCD_TX_BUFFER_SIZE) {
+        return 1;
+    }
+    
+    if (!LCD_IS_ASYNC()) {
+        uint32_t start = HAL_GetTick();
+        
+        while (LCD_INIT_PENDING() &&
+               (HAL_GetTick() - start) <= LCD_POWER_ON_MS + LCD_INIT_TIMEOUT_MS) {
+            LCD_InitAdvance(hlcd);
+        }
+        LCD_Commit(hlcd);
+        if (count < LCD_TX_BUFFER_SIZE && hlcd->init_step == LCD_INIT_DONE) {
+            return 1;
+        }
+    }
+    
+    hlcd->tx_overflow = 1;
+    return 0;
+}
+
+/**
+  * @brief  Writes one expander byte at the encoder position
+  * @param  packet: PCF8574 pin state
+  */
+static void LCD_Put(LCD_HandleTypeDef* hlcd, uint8_t packet)
+{
+    hlcd->tx_buf[hlcd->tx_wr] = packet;
+    hlcd->tx_wr = (hlcd->tx_wr + 1) % LCD_TX_BUFFER_SIZE;
+}
+
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+/**
+  * @brief  Writes encoded expander bytes at the encoder position
+  * @param  packets: PCF8574 pin states
+  * @param  len: Number of bytes
+  */
+static void LCD_PutBlock(LCD_HandleTypeDef* hlcd, const uint8_t* packets, uint16_t len)
+{
+    if (!LCD_Reserve(hlcd, len)) {
+        return;
+    }
+    
+    while (len--) {
+        LCD_Put(hlcd, *packets++);
+    }
+}
+
+/**
+  * @brief  Encodes one LCD byte into a linear buffer
+  * @note   Two nibbles of EN high + EN low, then the pad bytes that cover
+  *         the execution time on fast buses
+  * @param  out: Destination, LCD_BYTE_WIRE_COST bytes
+  * @param  data: 8-bit data
+  * @param  rs: Register select (0 for command, 1 for data)
+  * @retval Number of bytes written (LCD_BYTE_WIRE_COST)
+  */
+static uint8_t LCD_EncodeByte(uint8_t* out, uint8_t data, uint8_t rs)
+{
+    uint8_t packet = rs ? LCD_RS : 0;
+#if LCD_USE_ENCODE_TABLE
+    const uint8_t* enc = lcd_encode_tab[data];
+    
+    out[0] = enc[0] | packet;
+    out[1] = enc[1] | packet;
+    out[2] = enc[2] | packet;
+    out[3] = enc[3] | packet;
+#else
+    uint8_t high = (data & 0xF0) | LCD_BACKLIGHT | packet;
+    uint8_t low = ((data << 4) & 0xF0) | LCD_BACKLIGHT | packet;
+    
+    out[0] = high | LCD_EN;
+    out[1] = high;
+    out[2] = low | LCD_EN;
+    out[3] = low;
+#endif
+    
+    for (uint8_t i = 4; i < LCD_BYTE_WIRE_COST; i++) {
+        out[i] = LCD_IDLE_BYTE | packet;
+    }
+    
+    return LCD_BYTE_WIRE_COST;
+}
+
+/**
+  * @brief  Encodes a run of data bytes straight into the queue
+  * @note   Same bytes as LCD_WriteData per character, but the queue space
+  *         is reserved once per chunk and bytes that do not straddle the
+  *         ring end are encoded in place
+  * @param  data: Characters to write
+  * @param  len: Number of characters
+  */
+static void LCD_PutData(LCD_HandleTypeDef* hlcd, const uint8_t* data, uint16_t len)
+{
+    // Largest run the blocking transport can queue behind a drained ring
+    const uint16_t chunk = (LCD_TX_BUFFER_SIZE - 1) / LCD_BYTE_WIRE_COST;
+    
+    while (len > 0) {
+        uint16_t n = (len < chunk) ? len : chunk;
+        
+        if (!LCD_Reserve(hlcd, n * LCD_BYTE_WIRE_COST)) {
+            return;
+        }
+        len -= n;
+        
+        while (n--) {
+            uint16_t wr = hlcd->tx_wr;
+            
+            if (wr + LCD_BYTE_WIRE_COST <= LCD_TX_BUFFER_SIZE) {
+                LCD_EncodeByte(&hlcd->tx_buf[wr], *data, 1);
+                hlcd->tx_wr = (wr + LCD_BYTE_WIRE_COST) % LCD_TX_BUFFER_SIZE;
+            } else {
+                uint8_t encoded[LCD_BYTE_WIRE_COST];
+                
+                LCD_EncodeByte(encoded, *data, 1);
+                for (uint8_t i = 0; i < LCD_BYTE_WIRE_COST; i++) {
+                    LCD_Put(hlcd, encoded[i]);
+                }
+            }
+            
+            LCD_Track(hlcd, *data++, 1);
+        }
+    }
+}
+#endif
+
+/**
+  * @brief  Publishes encoded bytes to the transport
+  * @note   Blocking transport: sends everything before returning.
+  *         Asynchronous transports: starts a transfer if the bus is idle.
+  */
+static void LCD_Commit(LCD_HandleTypeDef* hlcd)
+{
+    hlcd->tx_head = hlcd->tx_wr;
+    
+    // What a rolled-back operation returns to
+    hlcd->committed.ac = hlcd->ac;
+    hlcd->committed.cgram_ac = hlcd->cgram_ac;
+    hlcd->committed.entry_mode = hlcd->entry_mode;
+    hlcd->committed.display_ctrl = hlcd->display_ctrl;
+    hlcd->committed.function_set = hlcd->function_set;
+    hlcd->committed.stale = hlcd->stale;
+    
+    if (LCD_INIT_PENDING()) {
+        return;  // Sent by LCD_InitAdvance after the last step
+    }
+    
+    if (LCD_IS_ASYNC()) {
+        LCD_Kick(hlcd);
+        return;
+    }
+    
+    while (hlcd->tx_tail != hlcd->tx_head) {
+        uint16_t tail = hlcd->tx_tail;
+        uint16_t len = LCD_ChunkLen(hlcd);
+        
+        LCD_LatchStatus(hlcd, hlcd->transport->write(hlcd->ctx, hlcd->addr,
+                                                     &hlcd->tx_buf[tail], len));
+        hlcd->tx_tail = (tail + len) % LCD_TX_BUFFER_SIZE;
+    }
+}
+
+/**
+  * @brief  Starts the next asynchronous chunk if none is running
+  * @note   Safe to call from thread and interrupt context
+  */
+static void LCD_Kick(LCD_HandleTypeDef* hlcd)
+{
+    if (hlcd->transport == NULL || !LCD_IS_ASYNC() || LCD_INIT_PENDING()) {
+        return;
+    }
+    
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    
+    if (hlcd->tx_inflight == 0 && hlcd->tx_tail != hlcd->tx_head &&
+        hlcd->ctx != lcd_bus_owner) {
+        uint16_t tail = hlcd->tx_tail;
+        uint16_t len = LCD_ChunkLen(hlcd);
+        
+        hlcd->tx_inflight = len;
+        if (hlcd->transport->submit(hlcd->ctx, hlcd->addr,
+                                    &hlcd->tx_buf[tail], len) != LCD_OK) {
+            // Bus in use by another driver: LCD_Process retries later
+            hlcd->tx_inflight = 0;
+        }
+    }
+    
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Length of the next transaction
+  * @note   Transfers need a contiguous region, so a chunk stops at the end
+  *         of the ring, and at LCD_BUS_CHUNK_MAX bytes. Splitting between
+  *         any two bytes is safe: the PCF8574 holds its pins meanwhile.
+  * @retval Number of bytes from tx_tail
+  */
+static uint16_t LCD_ChunkLen(LCD_HandleTypeDef* hlcd)
+{
+    uint16_t tail = hlcd->tx_tail;
+    uint16_t head = hlcd->tx_head;
+    uint16_t len = (head > tail) ? (head - tail) : (LCD_TX_BUFFER_SIZE - tail);
+    
+    return (len > LCD_BUS_CHUNK_MAX) ? LCD_BUS_CHUNK_MAX : len;
+}
+
+/**
+  * @brief  Works out what one display receives from a broadcast
+  * @param  cgram: 1 for a CGRAM pattern, 0 for a DDRAM string
+  * @param  pos: CGRAM location, or row
+  * @param  col: Column (DDRAM only)
+  * @param  len: Number of data bytes
+  * @param  cmd: Set-address command for this display
+  * @retval Number of data bytes for this display (0 = off screen)
+  */
+static uint8_t LCD_BroadcastSpan(LCD_HandleTypeDef* hlcd, uint8_t cgram, uint8_t pos,
+                                 uint8_t col, uint8_t len, uint8_t* cmd)
+{
+    if (cgram) {
+        *cmd = LCD_SET_CGRAM_ADDR | (pos << 3);
+        return len;
+    }
+    
+    if (pos >= LCD_GEO_ROWS(hlcd) || col >= LCD_GEO_COLS(hlcd)) {
+        return 0;
+    }
+    
+    *cmd = LCD_SET_DDRAM_ADDR | (LCD_GEO_OFFSET(hlcd, pos) + col);
+    return (len > LCD_GEO_COLS(hlcd) - col) ? LCD_GEO_COLS(hlcd) - col : len;
+}
+
+/**
+  * @brief  Encodes data bytes once and queues them for several displays
+  * @note   Data is encoded LCD_BROADCAST_CHUNK bytes at a time into a
+  *         stack buffer that is copied into every display's queue, so the
+  *         encoding cost does not grow with the number of displays. The
+  *         queues are then committed one after the other.
+  * @param  cgram: 1 for a CGRAM pattern, 0 for a DDRAM string
+  * @param  pos: CGRAM location, or row
+  * @param  col: Column (DDRAM only)
+  * @param  data: Data bytes
+  * @param  len: Number of data bytes
+  * @retval LCD_StatusTypeDef: First error of any display, else LCD_OK
+  */
+static LCD_StatusTypeDef LCD_Broadcast(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                       uint8_t cgram, uint8_t pos, uint8_t col,
+                                       const uint8_t* data, uint8_t len)
+{
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+    uint8_t encoded[LCD_BROADCAST_CHUNK * LCD_BYTE_WIRE_COST];
+#endif
+    LCD_StatusTypeDef status = LCD_OK;
+    uint8_t cmd;
+    
+    // Set-address commands differ per display; as in LCD_SetCursor, none
+    // is sent where the address counter already points at the target
+    for (uint8_t i = 0; i < count; i++) {
+        LCD_HandleTypeDef* hlcd = hlcds[i];
+        
+        if (hlcd == NULL || hlcd->transport == NULL) {
+            status = LCD_NOT_INITIALIZED;
+        } else if (LCD_BroadcastSpan(hlcd, cgram, pos, col, len, &cmd) > 0 &&
+                   (cgram || hlcd->ac != (cmd & 0x7F))) {
+            LCD_WriteByte(hlcd, cmd, 0);
+        }
+    }
+    
+    for (uint8_t done = 0; done < len; ) {
+        uint8_t n = (len - done > LCD_BROADCAST_CHUNK) ? LCD_BROADCAST_CHUNK : len - done;
+        
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+        // Encode once...
+        for (uint8_t k = 0; k < n; k++) {
+            LCD_EncodeByte(&encoded[k * LCD_BYTE_WIRE_COST], data[done + k], 1);
+        }
+#endif
+        
+        // ...copy for every display that shows these bytes
+        for (uint8_t i = 0; i < count; i++) {
+            LCD_HandleTypeDef* hlcd = hlcds[i];
+            uint8_t span;
+            
+            if (hlcd == NULL || hlcd->transport == NULL) {
+                continue;
+            }
+            span = LCD_BroadcastSpan(hlcd, cgram, pos, col, len, &cmd);
+            if (span <= done) {
+                continue;
+            }
+            span = (span - done > n) ? n : span - done;
+            
+#if (LCD_TIMING_MODE == LCD_TIMING_BUS)
+            LCD_PutBlock(hlcd, encoded, span * LCD_BYTE_WIRE_COST);
+            for (uint8_t k = 0; k < span; k++) {
+                LCD_Track(hlcd, data[done + k], 1);
+            }
+#else
+            // Per-nibble waits cannot be shared: encode per display
+            for (uint8_t k = 0; k < span; k++) {
+                LCD_WriteData(hlcd, data[done + k]);
+            }
+#endif
+        }
+        
+        done += n;
+    }
+    
+    // Send display after display
+    for (uint8_t i = 0; i < count; i++) {
+        if (hlcds[i] != NULL && hlcds[i]->transport != NULL) {
+            LCD_StatusTypeDef result = LCD_FlushTx(hlcds[i]);
+            if (status == LCD_OK) {
+                status = result;
+            }
+        }
+    }
+    
+    return status;
+}
+
+/**
+  * @brief  Offers the bus to the next display on it that has queued bytes
+  * @note   Starts with the display after hlcd, so displays sharing an I2C
+  *         peripheral take turns chunk by chunk
+  * @param  hlcd: Display whose transfer just ended
+  */
+static void LCD_KickBus(LCD_HandleTypeDef* hlcd)
+{
+    LCD_HandleTypeDef* h = hlcd;
+    
+    do {
+        h = (h->next != NULL) ? h->next : lcd_handles;
+        if (h == NULL) {
+            return;  // hlcd is not registered
+        }
+        if (h->ctx == hlcd->ctx) {
+            LCD_Kick(h);
+            if (h->tx_inflight != 0) {
+                return;
+            }
+        }
+    } while (h != hlcd);
+}
+
+/**
+  * @brief  Finds the display whose transfer is running on a bus
+  * @param  ctx: Transport context of the bus
+  * @retval Handle, or NULL if no transfer of this driver is running
+  */
+static LCD_HandleTypeDef* LCD_FindInflight(void* ctx)
+{
+    for (LCD_HandleTypeDef* h = lcd_handles; h != NULL; h = h->next) {
+        if (h->ctx == ctx && h->transport != NULL && h->tx_inflight != 0) {
+            return h;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+  * @brief  Adds a handle to the list of initialized displays
+  * @param  hlcd: LCD handle
+  */
+static void LCD_Register(LCD_HandleTypeDef* hlcd)
+{
+    for (LCD_HandleTypeDef* h = lcd_handles; h != NULL; h = h->next) {
+        if (h == hlcd) {
+            return;
+        }
+    }
+    
+    hlcd->next = lcd_handles;
+    lcd_handles = hlcd;
+}
+
+/**
+  * @brief  Records the first transfer error until it is reported
+  * @param  status: Result of a transfer
+  */
+static void LCD_LatchStatus(LCD_HandleTypeDef* hlcd, LCD_StatusTypeDef status)
+{
+    if (hlcd->tx_status == LCD_OK) {
+        hlcd->tx_status = status;
+    }
+}
+
+/**
+  * @brief  Commits the encoded bytes and reports the operation status
+  * @retval LCD_StatusTypeDef: LCD_BUSY if the queue overflowed (nothing of
+  *         the operation is sent), else the first error since the last call
+  */
+static LCD_StatusTypeDef LCD_FlushTx(LCD_HandleTypeDef* hlcd)
+{
+    LCD_StatusTypeDef status;
+    
+    if (hlcd->tx_overflow) {
+        // Roll back the partially encoded operation and what it did to
+        // the shadows; nothing of it reached the LCD
+        hlcd->tx_wr = hlcd->tx_head;
+        hlcd->tx_overflow = 0;
+        hlcd->ac = hlcd->committed.ac;
+        hlcd->cgram_ac = hlcd->committed.cgram_ac;
+        hlcd->entry_mode = hlcd->committed.entry_mode;
+        hlcd->display_ctrl = hlcd->committed.display_ctrl;
+        hlcd->function_set = hlcd->committed.function_set;
+        hlcd->stale = hlcd->committed.stale;
+        return LCD_BUSY;
+    }
+    
+    LCD_Commit(hlcd);
+    
+    // Report (and clear) the first error, including ones from implicit flushes
+    status = hlcd->tx_status;
+    hlcd->tx_status = LCD_OK;
+    
+    if (status != LCD_OK) {
+        // Some bytes may not have reached the LCD: the next write sends
+        // the registers again (LCD_Resync) and sets an address
+        hlcd->ac = LCD_ADDR_UNKNOWN;
+        hlcd->cgram_ac = LCD_ADDR_UNKNOWN;
+        hlcd->stale = LCD_REG_ALL;
+    }
+    
+    return status;
+}
+
+/* HAL transports ------------------------------------------------------------*/
+
+/**
+  * @brief  Converts a HAL status to an LCD status
+  * @param  hal: HAL status
+  * @retval LCD_StatusTypeDef: Matching LCD status
+  */
+static LCD_StatusTypeDef LCD_HAL_Status(HAL_StatusTypeDef hal)
+{
+    switch (hal) {
+        case HAL_OK:      return LCD_OK;
+        case HAL_BUSY:    return LCD_BUSY;
+        case HAL_TIMEOUT: return LCD_TIMEOUT;
+        default:          return LCD_ERROR;
+    }
+}
+
+/**
+  * @brief  Blocking write through HAL_I2C_Master_Transmit
+  */
+static LCD_StatusTypeDef LCD_HAL_Write(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len)
+{
+    // Timeout scales with length: ~11 bytes per ms at 100 kHz
+    return LCD_HAL_Status(HAL_I2C_Master_Transmit((I2C_HandleTypeDef*)ctx, addr,
+                                                  (uint8_t*)data, len, 10 + len / 8));
+}
+
+/**
+  * @brief  Blocking read through HAL_I2C_Master_Receive
+  */
+static LCD_StatusTypeDef LCD_HAL_Read(void* ctx, uint8_t addr, uint8_t* data, uint16_t len)
+{
+    return LCD_HAL_Status(HAL_I2C_Master_Receive((I2C_HandleTypeDef*)ctx, addr,
+                                                 data, len, 10 + len / 8));
+}
+
+/**
+  * @brief  Starts a write through HAL_I2C_Master_Transmit_DMA
+  */
+static LCD_StatusTypeDef LCD_HAL_SubmitDMA(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len)
+{
+    return LCD_HAL_Status(HAL_I2C_Master_Transmit_DMA((I2C_HandleTypeDef*)ctx, addr,
+                                                      (uint8_t*)data, len));
+}
+
+/**
+  * @brief  Starts a write through HAL_I2C_Master_Transmit_IT
+  */
+static LCD_StatusTypeDef LCD_HAL_SubmitIT(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len)
+{
+    // Bytes are pumped from the I2C event ISR, no DMA channel needed
+    return LCD_HAL_Status(HAL_I2C_Master_Transmit_IT((I2C_HandleTypeDef*)ctx, addr,
+                                                     (uint8_t*)data, len));
+}
+
+/**
+  * @brief  Reports whether the submitted HAL transfer has finished
+  */
+static LCD_StatusTypeDef LCD_HAL_Poll(void* ctx)
+{
+    I2C_HandleTypeDef* hi2c = (I2C_HandleTypeDef*)ctx;
+    
+    // Fallback for when the HAL callbacks are not routed to the driver
+    if (HAL_I2C_GetState(hi2c) != HAL_I2C_STATE_READY) {
+        return LCD_BUSY;
+    }
+    
+    return (HAL_I2C_GetError(hi2c) == HAL_I2C_ERROR_NONE) ? LCD_OK : LCD_ERROR;
+}
+
+const LCD_TransportTypeDef LCD_Transport_HAL = {
+    LCD_HAL_Write, LCD_HAL_Read, NULL, NULL
+};
+
+const LCD_TransportTypeDef LCD_Transport_HAL_DMA = {
+    LCD_HAL_Write, LCD_HAL_Read, LCD_HAL_SubmitDMA, LCD_HAL_Poll
+};
+
+const LCD_TransportTypeDef LCD_Transport_HAL_IT = {
+    LCD_HAL_Write, LCD_HAL_Read, LCD_HAL_SubmitIT, LCD_HAL_Poll
+};
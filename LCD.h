@@ -19,6 +19,126 @@ extern "C" {
 #include <stdint.h>
 #include <stm32c0xx_hal.h>
 
+/* Configuration -------------------------------------------------------------*/
+
+// Transport used by LCD_Init (LCD_InitTransport takes any transport)
+#define LCD_TRANSPORT_BLOCKING  0  // HAL_I2C_Master_Transmit, returns when sent
+#define LCD_TRANSPORT_DMA       1  // HAL_I2C_Master_Transmit_DMA, returns at once
+#define LCD_TRANSPORT_IT        2  // HAL_I2C_Master_Transmit_IT, returns at once
+
+#ifndef LCD_TRANSPORT
+#define LCD_TRANSPORT           LCD_TRANSPORT_BLOCKING
+#endif
+
+// Set to 0 if the application defines HAL_I2C_MasterTxCpltCallback and
+// HAL_I2C_ErrorCallback itself; it must then call LCD_TxCpltCallback and
+// LCD_ErrorCallback from them.
+#ifndef LCD_DEFINE_HAL_CALLBACKS
+#define LCD_DEFINE_HAL_CALLBACKS (LCD_TRANSPORT != LCD_TRANSPORT_BLOCKING)
+#endif
+
+// Transmit queue size in expander bytes (4 per LCD byte). The blocking
+// default holds a set-address command plus one full 20-column row; the
+// asynchronous default holds about three rows.
+#ifndef LCD_TX_BUFFER_SIZE
+#if (LCD_TRANSPORT == LCD_TRANSPORT_BLOCKING)
+#define LCD_TX_BUFFER_SIZE      96
+#else
+#define LCD_TX_BUFFER_SIZE      256
+#endif
+#endif
+
+// I2C address used by LCD_Init (shifted left by 1 bit). LCD_ADDR_AUTO
+// probes the PCF8574 and PCF8574A ranges on the first LCD_Init instead.
+#ifndef LCD_I2C_ADDRESS
+#define LCD_I2C_ADDRESS         (0x27 << 1)
+#endif
+
+// I2C bus clock. Used to derive how much wire time one expander byte takes.
+#ifndef LCD_I2C_CLOCK_HZ
+#define LCD_I2C_CLOCK_HZ        100000
+#endif
+
+// Longest time one display may hold the I2C bus per transaction. Queued
+// traffic is sent in chunks that fit, and displays sharing a bus take
+// turns chunk by chunk, so other bus users wait at most this long (see
+// LCD_BusAcquire). 0 = no limit. Asynchronous transports only by default:
+// with the blocking transport nothing else can use the bus meanwhile.
+#ifndef LCD_BUS_MAX_HOLD_US
+#if (LCD_TRANSPORT == LCD_TRANSPORT_BLOCKING)
+#define LCD_BUS_MAX_HOLD_US     0
+#else
+#define LCD_BUS_MAX_HOLD_US     2000
+#endif
+#endif
+
+// Timing modes
+#define LCD_TIMING_BUS          0  // Datasheet waits from bus byte time + LCD_DelayUs
+#define LCD_TIMING_DELAY        1  // 1 ms HAL_Delay after every nibble (slow clones)
+
+#ifndef LCD_TIMING_MODE
+#define LCD_TIMING_MODE         LCD_TIMING_BUS
+#endif
+
+// LCD_TIMING_DELAY sleeps between nibbles, which only the blocking transport
+// can do; queued as idle bytes, one character is longer than a 20-cell row
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY) && (LCD_TRANSPORT != LCD_TRANSPORT_BLOCKING)
+#error "LCD_TIMING_DELAY requires LCD_TRANSPORT_BLOCKING"
+#endif
+
+// Set to 1 to poll the HD44780 busy flag over RW (PCF8574 P1) instead of
+// sleeping through clear/home, and through every byte in LCD_TIMING_DELAY.
+// Blocking transport only; reads that fail fall back to the timed waits.
+#ifndef LCD_USE_BUSY_FLAG
+#define LCD_USE_BUSY_FLAG       0
+#endif
+
+// Set to 0 to compute the expander bytes of each LCD byte instead of
+// looking them up in a 1 KB flash table. LCD_TIMING_BUS only.
+#ifndef LCD_USE_ENCODE_TABLE
+#define LCD_USE_ENCODE_TABLE    1
+#endif
+
+// Geometry presets for LCD_GEOMETRY (rows << 8 | columns)
+#define LCD_GEOMETRY_16x2       0x0210
+#define LCD_GEOMETRY_16x4       0x0410
+#define LCD_GEOMETRY_20x2       0x0214
+#define LCD_GEOMETRY_20x4       0x0414
+#define LCD_GEOMETRY_40x2       0x0228
+
+// Display geometry: a preset, or LCD_ROWS and LCD_COLS for other modules.
+// With LCD_ROWS 1 the controller runs in 1-line mode, otherwise 2-line.
+#ifdef LCD_GEOMETRY
+#define LCD_ROWS                (LCD_GEOMETRY >> 8)
+#define LCD_COLS                (LCD_GEOMETRY & 0xFF)
+#endif
+#ifndef LCD_ROWS
+#define LCD_ROWS                4
+#endif
+#ifndef LCD_COLS
+#define LCD_COLS                20
+#endif
+
+#if (LCD_ROWS < 1) || (LCD_ROWS > 4) || (LCD_COLS < 1) || (LCD_COLS > 40)
+#error "LCD_ROWS must be 1-4 and LCD_COLS 1-40"
+#endif
+#if (LCD_ROWS > 2) && (LCD_COLS > 20)
+#error "Rows 2 and 3 share the 40-cell DDRAM lines of rows 0 and 1: 20 columns max"
+#endif
+
+// Set to 1 when every display is LCD_ROWS x LCD_COLS. Row offsets and
+// bounds checks then fold to constants, the handle drops its geometry
+// fields and LCDx_SetGeometry accepts only that geometry.
+#ifndef LCD_FIXED_GEOMETRY
+#define LCD_FIXED_GEOMETRY      0
+#endif
+
+// Set to 1 to keep a RAM shadow of the display. Print functions then only
+// update the shadow and LCD_Flush sends the cells that changed.
+#ifndef LCD_USE_FRAMEBUFFER
+#define LCD_USE_FRAMEBUFFER     0
+#endif
+
 /* Public defines ------------------------------------------------------------*/
 
 // LCD commands
@@ -60,12 +180,18 @@ extern "C" {
 #define LCD_5x10DOTS            0x04
 #define LCD_5x8DOTS             0x00
 
+// Address that makes LCD_Init/LCDx_Init probe for the backpack
+#define LCD_ADDR_AUTO           0x00
+
 // Control pins pada PCF8574
 #define LCD_RS                  0x01  // Register Select
 #define LCD_RW                  0x02  // Read/Write
 #define LCD_EN                  0x04  // Enable
 #define LCD_BACKLIGHT           0x08  // Backlight
 
+// Framebuffer row length: LCD_COLS rounded up to whole 32-bit words
+#define LCD_FB_STRIDE           ((LCD_COLS + 3) & ~3)
+
 /* Public types --------------------------------------------------------------*/
 typedef enum {
     LCD_OK = 0,
@@ -75,6 +201,130 @@ typedef enum {
     LCD_TIMEOUT
 } LCD_StatusTypeDef;
 
+/**
+  * @brief  Byte transport between the driver and the PCF8574
+  * @note   ctx is passed back unchanged (e.g. an I2C_HandleTypeDef*) and addr
+  *         is the shifted 8-bit I2C address. read, submit and poll may be
+  *         NULL. A transport with submit is asynchronous: it reports the end
+  *         of a transfer through LCDx_TransportDone, or through poll.
+  */
+typedef struct {
+    // Blocking write; returns when the bytes are on the wire
+    LCD_StatusTypeDef (*write)(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len);
+    // Blocking read (optional)
+    LCD_StatusTypeDef (*read)(void* ctx, uint8_t addr, uint8_t* data, uint16_t len);
+    // Starts a write and returns at once; data stays valid until completion
+    LCD_StatusTypeDef (*submit)(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len);
+    // LCD_BUSY while a submitted write runs, then its result (optional)
+    LCD_StatusTypeDef (*poll)(void* ctx);
+} LCD_TransportTypeDef;
+
+typedef enum {
+    LCD_ALIGN_RIGHT = 0,
+    LCD_ALIGN_LEFT
+} LCD_AlignTypeDef;
+
+// Widest field: "-2147483648"
+#define LCD_FIELD_MAX_WIDTH     11
+
+/**
+  * @brief  Fixed-width numeric field that is updated in place
+  * @note   Set up with LCD_FieldInit; the last two members are private
+  */
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    uint8_t width;                          // Cells, 1-LCD_FIELD_MAX_WIDTH
+    LCD_AlignTypeDef align;
+    char pad;                               // Fill character, e.g. ' ' or '0'
+    uint8_t is_signed;                      // 1: int32_t, 0: uint32_t
+    int32_t value;                          // Last rendered value
+    uint8_t shown[LCD_FIELD_MAX_WIDTH];     // Cells as last sent (0 = never)
+} LCD_FieldTypeDef;
+
+/**
+  * @brief  HD44780 register shadows as of the last commit (private)
+  * @note   An operation that overflows the transmit queue is rolled back
+  *         to this state
+  */
+typedef struct {
+    uint8_t ac;
+    uint8_t cgram_ac;
+    uint8_t entry_mode;
+    uint8_t display_ctrl;
+    uint8_t function_set;
+    uint8_t stale;
+} LCD_ShadowTypeDef;
+
+/**
+  * @brief  One display: its bus, address, geometry, register shadows and
+  *         buffers
+  * @note   Set up with LCDx_Init or LCDx_InitTransport; all members are
+  *         private to the driver. Each handle holds its own transmit queue
+  *         (LCD_TX_BUFFER_SIZE) and, in framebuffer mode, two
+  *         LCD_ROWS x LCD_COLS shadows.
+  */
+typedef struct LCD_HandleTypeDef {
+    const LCD_TransportTypeDef* transport;  // NULL until initialized
+    void* ctx;                              // Transport context (I2C handle)
+    uint8_t addr;                           // I2C address (shifted left by 1 bit)
+    
+#if !LCD_FIXED_GEOMETRY
+    // Geometry: DDRAM address of the first column of each row
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t row_offsets[LCD_ROWS];
+#endif
+    
+    // HD44780 state as last sent
+    uint8_t ac;                             // Address counter (0xFF = unknown)
+    uint8_t cgram_ac;                       // Counter while in CGRAM (0xFF = not there)
+    uint8_t entry_mode;                     // Increment / shift bits
+    uint8_t display_ctrl;                   // Display on / cursor / blink bits
+    uint8_t function_set;                   // Interface / lines / font bits
+    uint8_t stale;                          // Shadows that may not match the LCD
+    LCD_ShadowTypeDef committed;            // Shadows as of tx_head
+    
+    // Power-on sequence: next step and the wait before it
+    uint8_t init_step;
+    uint8_t init_wait_ms;
+    uint32_t init_tick;
+#if LCD_USE_BUSY_FLAG
+    uint8_t busy_flag;                      // 1 while busy flag reads work
+#endif
+    
+    // Expander byte ring. The encoder writes at tx_wr, bytes become visible
+    // to the transport at tx_head, and the transport consumes from tx_tail.
+    uint8_t tx_buf[LCD_TX_BUFFER_SIZE];
+    uint16_t tx_wr;
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
+    volatile uint16_t tx_inflight;          // Length of the running async chunk
+    uint8_t tx_overflow;
+    volatile LCD_StatusTypeDef tx_status;
+    
+#if LCD_USE_FRAMEBUFFER
+    // Shadow of DDRAM as the application wants it, and as last sent. Rows
+    // are word aligned and padded so LCD_Flush compares 4 cells at a time.
+    uint8_t fb[LCD_ROWS][LCD_FB_STRIDE] __ALIGNED(4);
+    uint8_t fb_sent[LCD_ROWS][LCD_FB_STRIDE] __ALIGNED(4);
+    uint8_t fb_dirty;                       // Rows changed since last sent (bit per row)
+    uint8_t fb_repaint;                     // Rows to send in full (bit per row)
+    uint8_t fb_pending;                     // LCD_Flush ran out of queue space
+    uint8_t fb_row;
+    uint8_t fb_col;
+#endif
+    
+    struct LCD_HandleTypeDef* next;         // Next initialized display
+} LCD_HandleTypeDef;
+
+/* Public variables ----------------------------------------------------------*/
+
+// STM32 HAL transports; ctx is the I2C_HandleTypeDef*
+extern const LCD_TransportTypeDef LCD_Transport_HAL;
+extern const LCD_TransportTypeDef LCD_Transport_HAL_DMA;
+extern const LCD_TransportTypeDef LCD_Transport_HAL_IT;
+
 /* Public function prototypes ------------------------------------------------*/
 
 /**
@@ -84,6 +334,43 @@ typedef enum {
   */
 LCD_StatusTypeDef LCD_Init(I2C_HandleTypeDef* hi2c);
 
+/**
+  * @brief  Initializes LCD over any byte transport
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCD_InitTransport(const LCD_TransportTypeDef* transport, void* ctx);
+
+/**
+  * @brief  Starts initializing LCD and returns at once
+  * @note   LCD_Process runs the power-on sequence with its datasheet waits.
+  *         Draw calls made meanwhile are queued and shown when it is done.
+  * @param  hi2c: Pointer to I2C handle
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCD_InitStart(I2C_HandleTypeDef* hi2c);
+
+/**
+  * @brief  Reports whether the LCD is ready (advances the sequence too)
+  * @retval LCD_StatusTypeDef: LCD_OK when ready, LCD_BUSY while the
+  *         sequence runs, LCD_ERROR if the LCD did not answer
+  */
+LCD_StatusTypeDef LCD_InitStatus(void);
+
+/**
+  * @brief  Initializes LCD, keeping the screen if the LCD is still set up
+  * @note   After an MCU reset the HD44780 keeps its mode and contents. If
+  *         the busy flag and address counter read back from a 4-bit
+  *         controller, the power-on sequence and the clear are skipped;
+  *         otherwise this is LCD_Init. Needs the LCD RW pin on P1. In
+  *         framebuffer mode the screen is read back into the framebuffer
+  *         (about 1 ms per cell at 100 kHz).
+  * @param  hi2c: Pointer to I2C handle
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCD_InitWarm(I2C_HandleTypeDef* hi2c);
+
 /**
   * @brief  Clears LCD display
   * @retval LCD_StatusTypeDef: Status of operation
@@ -156,13 +443,33 @@ LCD_StatusTypeDef LCD_Cursor(uint8_t state);
   */
 LCD_StatusTypeDef LCD_Blink(uint8_t state);
 
+/**
+  * @brief  Sets the entry mode (text direction and display shift)
+  * @note   Nothing is sent if the mode is already set. In framebuffer mode
+  *         only LCD_ENTRY_LEFT without shift is supported.
+  * @param  mode: LCD_ENTRY_LEFT or LCD_ENTRY_RIGHT, ORed with
+  *         LCD_ENTRY_SHIFT_INC or LCD_ENTRY_SHIFT_DEC
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_SetEntryMode(uint8_t mode);
+
 /**
   * @brief  Sets LCD I2C address
+  * @note   LCD_ADDR_AUTO makes the next LCD_Init probe for the backpack
   * @param  address: I2C address (shifted left by 1 bit)
   * @retval LCD_StatusTypeDef: Status of operation
   */
 LCD_StatusTypeDef LCD_SetAddress(uint8_t address);
 
+/**
+  * @brief  Finds a PCF8574 (0x20-0x27) or PCF8574A (0x38-0x3F) backpack
+  * @note   Skips addresses of displays already initialized on the bus
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: First address that answered (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: LCD_OK, or LCD_ERROR if none answered
+  */
+LCD_StatusTypeDef LCD_DetectAddress(I2C_HandleTypeDef* hi2c, uint8_t* address);
+
 /**
   * @brief  Scrolls display left
   * @retval LCD_StatusTypeDef: Status of operation
@@ -189,6 +496,512 @@ LCD_StatusTypeDef LCD_Home(void);
   */
 LCD_StatusTypeDef LCD_Printf(const char* format, ...);
 
+/**
+  * @brief  Sets up a fixed-width numeric field
+  * @note   Nothing is drawn until the first LCD_FieldUpdate
+  * @param  field: Field to set up
+  * @param  row: Row of the first cell
+  * @param  col: Column of the first cell
+  * @param  width: Number of cells (1-LCD_FIELD_MAX_WIDTH)
+  * @param  align: LCD_ALIGN_RIGHT or LCD_ALIGN_LEFT
+  * @param  pad: Fill character (a '0' pad goes after the sign; not allowed
+  *         with LCD_ALIGN_LEFT)
+  * @param  is_signed: 1 to print the value as int32_t, 0 as uint32_t
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_FieldInit(LCD_FieldTypeDef* field, uint8_t row, uint8_t col,
+                                uint8_t width, LCD_AlignTypeDef align, char pad,
+                                uint8_t is_signed);
+
+/**
+  * @brief  Shows a new value in a numeric field, sending only changed cells
+  * @note   Values that do not fit are shown as '#' in every cell. After
+  *         LCD_Clear, call LCD_FieldInit again so the field is redrawn.
+  * @param  field: Field set up with LCD_FieldInit
+  * @param  value: Value to show (reinterpreted as uint32_t if unsigned)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_FieldUpdate(LCD_FieldTypeDef* field, int32_t value);
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Sends the framebuffer cells that differ from what the LCD shows
+  * @note   With DMA/IT a frame larger than the transmit queue is sent in
+  *         part: LCD_BUSY is returned and LCD_Process queues the remaining
+  *         rows as the queue drains (LCD_WaitIdle waits for all of them).
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_BUSY if partly sent, or an error
+  */
+LCD_StatusTypeDef LCD_Flush(void);
+
+/**
+  * @brief  Returns the cost of the next LCD_Flush without sending anything
+  * @retval Number of expander bytes LCD_Flush would queue (waits excluded)
+  */
+uint16_t LCD_FlushPlan(void);
+#endif
+
+/**
+  * @brief  Checks whether all queued LCD traffic has been sent
+  * @retval 1 if the transmit queue is empty, 0 otherwise
+  */
+uint8_t LCD_IsIdle(void);
+
+/**
+  * @brief  Waits until all queued LCD traffic has been sent
+  * @param  timeout: Timeout in milliseconds
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_TIMEOUT or the first transfer error
+  */
+LCD_StatusTypeDef LCD_WaitIdle(uint32_t timeout);
+
+/**
+  * @brief  Reads the HD44780 busy flag and address counter
+  * @note   Needs the LCD RW pin wired to the PCF8574 (P1)
+  * @param  status: Busy flag (bit 7) and address counter (bits 0-6)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_ReadStatus(uint8_t* status);
+
+/**
+  * @brief  Reads the characters of one row back from DDRAM
+  * @note   Needs the LCD RW pin on P1; about 1 ms per character at 100 kHz
+  * @param  row: Row number
+  * @param  buf: Receives one byte per column
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_ReadRow(uint8_t row, uint8_t* buf);
+
+/**
+  * @brief  Reads a custom character pattern back from CGRAM
+  * @param  location: Character location (0-7)
+  * @param  charmap: Receives 8 rows of 5 bits
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_ReadChar(uint8_t location, uint8_t charmap[]);
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Loads the framebuffer with what the LCD shows
+  * @note   LCD_InitWarm already does this. Use it again when something
+  *         else may have written to the LCD, so LCD_Flush only sends real
+  *         changes instead of repainting every cell
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCD_ReadBack(void);
+#endif
+
+/**
+  * @brief  Advances the transmit queues of all initialized displays
+  * @note   Call from the main loop when using an asynchronous transport
+  */
+void LCD_Process(void);
+
+/**
+  * @brief  Reports the end of a submitted transfer (asynchronous transports)
+  * @note   May be called from interrupt context. Acts on the display of
+  *         LCD_Init only; a transport shared with LCDx_ handles must call
+  *         LCDx_TransportDone with the handle the transfer belongs to.
+  * @param  status: LCD_OK, or the error the transfer ended with
+  */
+void LCD_TransportDone(LCD_StatusTypeDef status);
+
+/**
+  * @brief  Reserves an I2C bus shared with the displays for another device
+  * @note   Waits for the running display chunk (at most LCD_BUS_MAX_HOLD_US)
+  *         and keeps new display transfers off the bus until LCD_BusRelease.
+  *         One bus can be reserved at a time.
+  * @param  ctx: Transport context of the bus (e.g. &hi2c1)
+  * @param  timeout: Timeout in milliseconds
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_BUSY if another bus is reserved,
+  *         or LCD_TIMEOUT
+  */
+LCD_StatusTypeDef LCD_BusAcquire(void* ctx, uint32_t timeout);
+
+/**
+  * @brief  Ends a reservation made with LCD_BusAcquire
+  * @param  ctx: Transport context of the bus
+  */
+void LCD_BusRelease(void* ctx);
+
+/**
+  * @brief  I2C transmit complete handler for the HAL DMA/IT transports
+  * @param  hi2c: Pointer to I2C handle that completed
+  */
+void LCD_TxCpltCallback(I2C_HandleTypeDef* hi2c);
+
+/**
+  * @brief  I2C error handler for the HAL DMA/IT transports
+  * @param  hi2c: Pointer to I2C handle that failed
+  */
+void LCD_ErrorCallback(I2C_HandleTypeDef* hi2c);
+
+/* Multi-display API ---------------------------------------------------------*/
+/*
+ * Every call above exists once more with an LCD_HandleTypeDef* first, for
+ * boards with several displays (e.g. PCF8574 backpacks at 0x27, 0x26 and
+ * 0x25 on one bus). The calls above work on a default handle of their own.
+ */
+
+/**
+  * @brief  Initializes an LCD with associated I2C handle
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_Init(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address);
+
+/**
+  * @brief  Initializes an LCD over any byte transport
+  * @note   With LCD_TIMING_DELAY only blocking transports (no submit) are
+  *         accepted
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitTransport(LCD_HandleTypeDef* hlcd, const LCD_TransportTypeDef* transport,
+                                     void* ctx, uint8_t address);
+
+/**
+  * @brief  Starts initializing an LCD and returns at once
+  * @note   See LCD_InitStart; LCDx_InitStatus reports when it is ready
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCDx_InitTransportStart(LCD_HandleTypeDef* hlcd,
+                                          const LCD_TransportTypeDef* transport,
+                                          void* ctx, uint8_t address);
+
+/**
+  * @brief  Same as LCD_InitStart, on hlcd
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
+  * @retval LCD_StatusTypeDef: LCD_BUSY while the sequence runs, or an error
+  */
+LCD_StatusTypeDef LCDx_InitStart(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address);
+
+/**
+  * @brief  Same as LCD_InitStatus, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: LCD_OK when ready, LCD_BUSY while the
+  *         sequence runs, LCD_ERROR if the LCD did not answer
+  */
+LCD_StatusTypeDef LCDx_InitStatus(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_InitWarm, on hlcd
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  hi2c: Pointer to I2C handle
+  * @param  address: I2C address (shifted left by 1 bit), or LCD_ADDR_AUTO
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitWarm(LCD_HandleTypeDef* hlcd, I2C_HandleTypeDef* hi2c, uint8_t address);
+
+/**
+  * @brief  Same as LCDx_InitWarm, over any byte transport
+  * @note   Without a read op this is LCDx_InitTransport
+  * @param  hlcd: LCD handle (any storage; no setup needed)
+  * @param  transport: Transport functions (e.g. &LCD_Transport_HAL_DMA)
+  * @param  ctx: Transport context passed to every call
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of initialization
+  */
+LCD_StatusTypeDef LCDx_InitWarmTransport(LCD_HandleTypeDef* hlcd, const LCD_TransportTypeDef* transport,
+                                         void* ctx, uint8_t address);
+
+/**
+  * @brief  Stops using a handle (drops traffic that was not sent)
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: LCD_BUSY while a transfer of it is running
+  */
+LCD_StatusTypeDef LCDx_DeInit(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Sets the display geometry (default LCD_ROWS x LCD_COLS)
+  * @note   Call after init, e.g. for a 16x2 next to 20x4 displays. With
+  *         LCD_FIXED_GEOMETRY only LCD_ROWS x LCD_COLS is accepted. In
+  *         framebuffer mode the framebuffer is blanked and the next
+  *         LCDx_Flush rewrites the whole screen.
+  * @param  hlcd: LCD handle
+  * @param  rows: Number of rows (1-LCD_ROWS)
+  * @param  cols: Number of columns (1-LCD_COLS)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_SetGeometry(LCD_HandleTypeDef* hlcd, uint8_t rows, uint8_t cols);
+
+/**
+  * @brief  Same as LCD_SetAddress, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  address: I2C address (shifted left by 1 bit)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_SetAddress(LCD_HandleTypeDef* hlcd, uint8_t address);
+
+/**
+  * @brief  Same as LCD_Clear, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Clear(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_SetCursor, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  row: Row number
+  * @param  col: Column number
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_SetCursor(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t col);
+
+/**
+  * @brief  Same as LCD_PrintString, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  str: Null-terminated string
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_PrintString(LCD_HandleTypeDef* hlcd, const char* str);
+
+/**
+  * @brief  Same as LCD_PrintInt, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  num: Integer number
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_PrintInt(LCD_HandleTypeDef* hlcd, int32_t num);
+
+/**
+  * @brief  Same as LCD_PrintFloat, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  num: Float number
+  * @param  decimals: Number of decimal places (0-6)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_PrintFloat(LCD_HandleTypeDef* hlcd, float num, uint8_t decimals);
+
+/**
+  * @brief  Same as LCD_Printf, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  format: Format string
+  * @param  ...: Variable arguments
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Printf(LCD_HandleTypeDef* hlcd, const char* format, ...);
+
+/**
+  * @brief  Same as LCD_CreateChar, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  location: CGRAM location (0-7)
+  * @param  charmap: 8-byte array for character pattern
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_CreateChar(LCD_HandleTypeDef* hlcd, uint8_t location, uint8_t charmap[]);
+
+/**
+  * @brief  Same as LCD_WriteChar, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  location: CGRAM location (0-7)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_WriteChar(LCD_HandleTypeDef* hlcd, uint8_t location);
+
+/**
+  * @brief  Same as LCD_Display, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Display(LCD_HandleTypeDef* hlcd, uint8_t state);
+
+/**
+  * @brief  Same as LCD_Cursor, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Cursor(LCD_HandleTypeDef* hlcd, uint8_t state);
+
+/**
+  * @brief  Same as LCD_Blink, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  state: 1 for on, 0 for off
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Blink(LCD_HandleTypeDef* hlcd, uint8_t state);
+
+/**
+  * @brief  Same as LCD_SetEntryMode, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  mode: LCD_ENTRY_LEFT or LCD_ENTRY_RIGHT, ORed with
+  *         LCD_ENTRY_SHIFT_INC or LCD_ENTRY_SHIFT_DEC
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_SetEntryMode(LCD_HandleTypeDef* hlcd, uint8_t mode);
+
+/**
+  * @brief  Same as LCD_ScrollLeft, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ScrollLeft(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_ScrollRight, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ScrollRight(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_Home, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_Home(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_FieldInit, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  field: Field to set up
+  * @param  row: Row of the first cell
+  * @param  col: Column of the first cell
+  * @param  width: Number of cells (1-LCD_FIELD_MAX_WIDTH)
+  * @param  align: LCD_ALIGN_RIGHT or LCD_ALIGN_LEFT
+  * @param  pad: Fill character (a '0' pad goes after the sign; not allowed
+  *         with LCD_ALIGN_LEFT)
+  * @param  is_signed: 1 to print the value as int32_t, 0 as uint32_t
+  * @retval LCD_StatusTypeDef: Status of operation (LCD_NOT_INITIALIZED
+  *         for a NULL or uninitialized handle, LCD_ERROR for a NULL field)
+  */
+LCD_StatusTypeDef LCDx_FieldInit(LCD_HandleTypeDef* hlcd, LCD_FieldTypeDef* field, uint8_t row,
+                                 uint8_t col, uint8_t width, LCD_AlignTypeDef align, char pad,
+                                 uint8_t is_signed);
+
+/**
+  * @brief  Same as LCD_FieldUpdate, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  field: Field set up with LCDx_FieldInit
+  * @param  value: Value to show (reinterpreted as uint32_t if unsigned)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_FieldUpdate(LCD_HandleTypeDef* hlcd, LCD_FieldTypeDef* field, int32_t value);
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Same as LCD_Flush, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_BUSY if partly sent, or an error
+  */
+LCD_StatusTypeDef LCDx_Flush(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_FlushPlan, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval Number of expander bytes LCDx_Flush would queue (waits excluded)
+  */
+uint16_t LCDx_FlushPlan(LCD_HandleTypeDef* hlcd);
+#endif
+
+/**
+  * @brief  Same as LCD_IsIdle, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval 1 if the transmit queue is empty, 0 otherwise
+  */
+uint8_t LCDx_IsIdle(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Same as LCD_WaitIdle, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  timeout: Timeout in milliseconds
+  * @retval LCD_StatusTypeDef: LCD_OK, LCD_TIMEOUT or the first transfer error
+  */
+LCD_StatusTypeDef LCDx_WaitIdle(LCD_HandleTypeDef* hlcd, uint32_t timeout);
+
+/**
+  * @brief  Same as LCD_ReadStatus, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  status: Busy flag (bit 7) and address counter (bits 0-6)
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadStatus(LCD_HandleTypeDef* hlcd, uint8_t* status);
+
+/**
+  * @brief  Same as LCD_ReadRow, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  row: Row number
+  * @param  buf: Receives one byte per column
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadRow(LCD_HandleTypeDef* hlcd, uint8_t row, uint8_t* buf);
+
+/**
+  * @brief  Same as LCD_ReadChar, on hlcd
+  * @param  hlcd: LCD handle
+  * @param  location: Character location (0-7)
+  * @param  charmap: Receives 8 rows of 5 bits
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadChar(LCD_HandleTypeDef* hlcd, uint8_t location, uint8_t charmap[]);
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Same as LCD_ReadBack, on hlcd
+  * @param  hlcd: LCD handle
+  * @retval LCD_StatusTypeDef: Status of operation
+  */
+LCD_StatusTypeDef LCDx_ReadBack(LCD_HandleTypeDef* hlcd);
+#endif
+
+/**
+  * @brief  Advances the transmit queue of one display
+  * @note   LCD_Process calls it for every initialized display
+  * @param  hlcd: LCD handle
+  */
+void LCDx_Process(LCD_HandleTypeDef* hlcd);
+
+/**
+  * @brief  Reports the end of a submitted transfer of one display
+  * @note   May be called from interrupt context. Custom asynchronous
+  *         transports call it with the handle the transfer belongs to.
+  * @param  hlcd: LCD handle
+  * @param  status: LCD_OK, or the error the transfer ended with
+  */
+void LCDx_TransportDone(LCD_HandleTypeDef* hlcd, LCD_StatusTypeDef status);
+
+/**
+  * @brief  Prints the same string at the same position on several displays
+  * @note   Encodes the characters once for all displays
+  * @param  hlcds: Displays
+  * @param  count: Number of displays
+  * @param  row: Row number
+  * @param  col: Column number
+  * @param  str: Null-terminated string
+  * @retval LCD_StatusTypeDef: First error of any display, else LCD_OK
+  */
+LCD_StatusTypeDef LCD_BroadcastString(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                      uint8_t row, uint8_t col, const char* str);
+
+/**
+  * @brief  Creates the same custom character on several displays
+  * @param  hlcds: Displays
+  * @param  count: Number of displays
+  * @param  location: CGRAM location (0-7)
+  * @param  charmap: 8-byte array for character pattern
+  * @retval LCD_StatusTypeDef: First error of any display, else LCD_OK
+  */
+LCD_StatusTypeDef LCD_BroadcastChar(LCD_HandleTypeDef* const hlcds[], uint8_t count,
+                                    uint8_t location, const uint8_t charmap[]);
+
+/**
+  * @brief  Busy-waits for a number of microseconds (weak, may be overridden)
+  * @param  us: Microseconds to wait
+  */
+void LCD_DelayUs(uint32_t us);
+
 /* Public macros -------------------------------------------------------------*/
 /**
   * @brief  Prints string at specific position
@@ -0,0 +1,292 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_bench.c
+  * @brief          : Benchmark of the LCD driver against the host simulator
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  * Runs fixed workloads through the public API and prints, per workload:
+  * I2C transactions and data bytes, HAL_Delay/LCD_DelayUs time, elapsed
+  * virtual time at 100 kHz, the bus time the same traffic would take at
+  * 100/400/1000 kHz, and simulator timing violations. After each workload
+  * the bench text is drawn (outside the measurement) and the simulated
+  * screen is compared with it; a mismatch fails the run.
+  *
+  *   gcc -O2 -I. -Ihost LCD.c host/stm32c0xx_hal.c host/lcd_sim.c \
+  *       host/lcd_bench.c -o lcd_bench
+  *   ./lcd_bench          CSV
+  *   ./lcd_bench --json   JSON
+  *
+  * Driver options (LCD_TRANSPORT, LCD_USE_FRAMEBUFFER, ...) are passed as -D
+  * flags, so different builds can be compared line by line.
+  */
+
+#include "LCD.h"
+#include "lcd_sim.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define BENCH_WAIT_MS           1000
+#define BENCH_FLUSH_TRIES       8     // LCD_Flush calls per frame at most
+
+/* Private types -------------------------------------------------------------*/
+typedef struct {
+    const char* name;
+    uint32_t (*run)(void);              // Returns the number of API calls
+} BENCH_WorkloadTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static LCD_SimTypeDef bench_sim;
+static I2C_HandleTypeDef bench_hi2c;
+
+static const char* const bench_text[4] = {
+    "ABCDEFGHIJKLMNOPQRST",
+    "abcdefghijklmnopqrst",
+    "0123456789:;<=>?@ABC",
+    "The quick brown fox "
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Ends one step of a workload: sends framebuffer changes and, in
+  *         async builds, drains the queue like a main loop would between
+  *         frames so the ring never overflows
+  */
+static void BENCH_Sync(void)
+{
+#if LCD_USE_FRAMEBUFFER
+    // A frame larger than the queue is sent in parts
+    for (uint8_t tries = 1; LCD_Flush() == LCD_BUSY && tries < BENCH_FLUSH_TRIES; tries++) {
+        LCD_WaitIdle(BENCH_WAIT_MS);
+    }
+#endif
+#if LCD_TRANSPORT != LCD_TRANSPORT_BLOCKING
+    LCD_WaitIdle(BENCH_WAIT_MS);
+#endif
+}
+
+/**
+  * @brief  Writes rows x cols characters, row by row
+  * @param  shift: Rotation of the text in the first iteration
+  */
+static uint32_t BENCH_Redraw(uint8_t rows, uint8_t cols, uint8_t shift, uint8_t iterations)
+{
+    char line[21];
+    uint32_t calls = 0;
+    
+    for (uint8_t i = 0; i < iterations; i++) {
+        for (uint8_t row = 0; row < rows; row++) {
+            // Rotate the text so every iteration really changes the screen
+            for (uint8_t col = 0; col < cols; col++) {
+                line[col] = bench_text[row][(col + shift + i) % 20];
+            }
+            line[cols] = '\0';
+            LCD_PRINT_AT(row, 0, line);
+            calls += 2;
+#if !LCD_USE_FRAMEBUFFER
+            BENCH_Sync();
+#endif
+        }
+        BENCH_Sync();
+    }
+    
+    return calls;
+}
+
+static uint32_t BENCH_Redraw16x2(void)
+{
+    return BENCH_Redraw(2, 16, 0, 10);
+}
+
+static uint32_t BENCH_Redraw20x4(void)
+{
+    return BENCH_Redraw(4, 20, 0, 10);
+}
+
+/**
+  * @brief  Counter ticking in a 5-digit field, printed the classic way
+  */
+static uint32_t BENCH_PrintIntAt(void)
+{
+    for (int32_t i = 0; i < 100; i++) {
+        LCD_PRINT_INT_AT(1, 10, 12000 + i * 7);
+        BENCH_Sync();
+    }
+    return 200;
+}
+
+/**
+  * @brief  Same counter through the numeric field API
+  */
+static uint32_t BENCH_FieldUpdate(void)
+{
+    LCD_FieldTypeDef field;
+    
+    LCD_FieldInit(&field, 1, 10, 5, LCD_ALIGN_RIGHT, ' ', 1);
+    for (int32_t i = 0; i < 100; i++) {
+        LCD_FieldUpdate(&field, 12000 + i * 7);
+        BENCH_Sync();
+    }
+    return 100;
+}
+
+/**
+  * @brief  Uploads all 8 custom characters
+  */
+static uint32_t BENCH_CreateChar(void)
+{
+    uint8_t pattern[8];
+    
+    for (uint8_t location = 0; location < 8; location++) {
+        for (uint8_t row = 0; row < 8; row++) {
+            pattern[row] = (uint8_t)((location * 8 + row) & 0x1F);
+        }
+        LCD_CreateChar(location, pattern);
+        BENCH_Sync();
+    }
+    return 8;
+}
+
+/**
+  * @brief  Clear followed by a full 20x4 rewrite
+  * @note   Each rewrite uses a new rotation of the text. With the framebuffer
+  *         a clear and a rewrite of the same text cancel out and nothing
+  *         would be sent.
+  */
+static uint32_t BENCH_ClearRewrite(void)
+{
+    uint32_t calls = 0;
+    
+    for (uint8_t i = 0; i < 10; i++) {
+        LCD_Clear();
+        calls += 1 + BENCH_Redraw(4, 20, i + 1, 1);
+    }
+    return calls;
+}
+
+/**
+  * @brief  Scrolls the display a full 40 positions
+  */
+static uint32_t BENCH_Scroll(void)
+{
+    for (uint8_t i = 0; i < 40; i++) {
+        LCD_ScrollLeft();
+        BENCH_Sync();
+    }
+    return 40;
+}
+
+/**
+  * @brief  Draws the bench text and checks that the simulator shows it
+  * @retval Number of rows that differ
+  */
+static uint8_t BENCH_Verify(void)
+{
+    char shown[41];
+    uint8_t bad = 0;
+    
+    for (uint8_t row = 0; row < 4; row++) {
+        LCD_PRINT_AT(row, 0, bench_text[row]);
+#if !LCD_USE_FRAMEBUFFER
+        BENCH_Sync();
+#endif
+    }
+    BENCH_Sync();
+    LCD_WaitIdle(BENCH_WAIT_MS);
+    
+    for (uint8_t row = 0; row < 4; row++) {
+        LCD_Sim_GetRow(&bench_sim, row, shown);
+        if (memcmp(shown, bench_text[row], 20) != 0) {
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static const BENCH_WorkloadTypeDef bench_workloads[] = {
+    { "redraw_16x2",    BENCH_Redraw16x2 },
+    { "redraw_20x4",    BENCH_Redraw20x4 },
+    { "print_int_at",   BENCH_PrintIntAt },
+    { "field_update",   BENCH_FieldUpdate },
+    { "create_char",    BENCH_CreateChar },
+    { "clear_rewrite",  BENCH_ClearRewrite },
+    { "scroll",         BENCH_Scroll },
+};
+
+/**
+  * @brief  Bus time of the recorded traffic at another clock
+  */
+static unsigned long long BENCH_BusUs(uint64_t bits, uint32_t hz)
+{
+    return (unsigned long long)((bits * 1000000ULL + hz - 1) / hz);
+}
+
+int main(int argc, char** argv)
+{
+    uint8_t json = (argc > 1 && strcmp(argv[1], "--json") == 0);
+    uint8_t count = sizeof(bench_workloads) / sizeof(bench_workloads[0]);
+    uint8_t failed = 0;
+    
+    LCD_Sim_Init(&bench_sim, 0x27 << 1, 4, 20);
+    if (LCD_Init(&bench_hi2c) != LCD_OK) {
+        fprintf(stderr, "LCD_Init failed\n");
+        return 1;
+    }
+    
+    if (json) {
+        printf("[\n");
+    } else {
+        printf("workload,calls,transactions,bytes,delay_ms,delay_us,elapsed_us,"
+               "bus_us_100k,bus_us_400k,bus_us_1m,violations\n");
+    }
+    
+    for (uint8_t i = 0; i < count; i++) {
+        const BENCH_WorkloadTypeDef* w = &bench_workloads[i];
+        uint32_t violations = bench_sim.violations;
+        uint64_t start;
+        uint32_t calls;
+        
+        LCD_WaitIdle(BENCH_WAIT_MS);
+        HOST_ResetStats();
+        start = HOST_GetMicros();
+        
+        calls = w->run();
+        LCD_WaitIdle(BENCH_WAIT_MS);
+        
+        HOST_BusStatsTypeDef s = HOST_BusStats;
+        unsigned long long elapsed = (unsigned long long)(HOST_GetMicros() - start);
+        violations = bench_sim.violations - violations;
+        
+        if (BENCH_Verify() != 0) {
+            fprintf(stderr, "%s: screen does not match after the workload\n", w->name);
+            failed = 1;
+        }
+        
+        if (json) {
+            printf("  {\"workload\": \"%s\", \"calls\": %u, \"transactions\": %u, "
+                   "\"bytes\": %u, \"delay_ms\": %u, \"delay_us\": %llu, "
+                   "\"elapsed_us\": %llu, \"bus_us_100k\": %llu, \"bus_us_400k\": %llu, "
+                   "\"bus_us_1m\": %llu, \"violations\": %u}%s\n",
+                   w->name, calls, s.transactions, s.bytes, s.delay_ms,
+                   (unsigned long long)s.delay_us, elapsed,
+                   BENCH_BusUs(s.bus_bits, 100000), BENCH_BusUs(s.bus_bits, 400000),
+                   BENCH_BusUs(s.bus_bits, 1000000), violations,
+                   (i + 1 < count) ? "," : "");
+        } else {
+            printf("%s,%u,%u,%u,%u,%llu,%llu,%llu,%llu,%llu,%u\n",
+                   w->name, calls, s.transactions, s.bytes, s.delay_ms,
+                   (unsigned long long)s.delay_us, elapsed,
+                   BENCH_BusUs(s.bus_bits, 100000), BENCH_BusUs(s.bus_bits, 400000),
+                   BENCH_BusUs(s.bus_bits, 1000000), violations);
+        }
+    }
+    
+    if (json) {
+        printf("]\n");
+    }
+    
+    return failed;
+}
@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_mock.c
+  * @brief          : Host mock transport for the LCD driver
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  */
+
+#include "lcd_mock.h"
+#include <string.h>
+
+/* Private function prototypes -----------------------------------------------*/
+static LCD_StatusTypeDef LCD_Mock_Write(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len);
+static LCD_StatusTypeDef LCD_Mock_Read(void* ctx, uint8_t addr, uint8_t* data, uint16_t len);
+static LCD_StatusTypeDef LCD_Mock_Submit(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len);
+static LCD_StatusTypeDef LCD_Mock_Poll(void* ctx);
+
+/* Public variables ----------------------------------------------------------*/
+const LCD_TransportTypeDef LCD_Transport_Mock = {
+    LCD_Mock_Write, LCD_Mock_Read, NULL, NULL
+};
+
+const LCD_TransportTypeDef LCD_Transport_MockAsync = {
+    LCD_Mock_Write, LCD_Mock_Read, LCD_Mock_Submit, LCD_Mock_Poll
+};
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  Clears captured data and counters
+  * @param  mock: Mock context
+  */
+void LCD_Mock_Reset(LCD_MockTypeDef* mock)
+{
+    memset(mock, 0, sizeof(*mock));
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Captures a write
+  */
+static LCD_StatusTypeDef LCD_Mock_Write(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len)
+{
+    LCD_MockTypeDef* mock = (LCD_MockTypeDef*)ctx;
+    
+    mock->last_addr = addr;
+    mock->transactions++;
+    
+    if (mock->fail_with != LCD_OK) {
+        return mock->fail_with;
+    }
+    
+    for (uint16_t i = 0; i < len; i++) {
+        if (mock->len < LCD_MOCK_CAPTURE_SIZE) {
+            mock->data[mock->len++] = data[i];
+        }
+    }
+    mock->bytes += len;
+    
+    return LCD_OK;
+}
+
+/**
+  * @brief  Returns read_value for every byte read
+  */
+static LCD_StatusTypeDef LCD_Mock_Read(void* ctx, uint8_t addr, uint8_t* data, uint16_t len)
+{
+    LCD_MockTypeDef* mock = (LCD_MockTypeDef*)ctx;
+    
+    mock->last_addr = addr;
+    mock->reads++;
+    
+    if (mock->fail_with != LCD_OK) {
+        return mock->fail_with;
+    }
+    
+    memset(data, mock->read_value, len);
+    return LCD_OK;
+}
+
+/**
+  * @brief  Captures a write and leaves it pending until the next poll
+  */
+static LCD_StatusTypeDef LCD_Mock_Submit(void* ctx, uint8_t addr, const uint8_t* data, uint16_t len)
+{
+    LCD_MockTypeDef* mock = (LCD_MockTypeDef*)ctx;
+    LCD_StatusTypeDef status;
+    
+    if (mock->pending) {
+        return LCD_BUSY;
+    }
+    
+    status = LCD_Mock_Write(ctx, addr, data, len);
+    if (status == LCD_OK) {
+        mock->pending = 1;
+    }
+    return status;
+}
+
+/**
+  * @brief  Completes the pending write
+  */
+static LCD_StatusTypeDef LCD_Mock_Poll(void* ctx)
+{
+    LCD_MockTypeDef* mock = (LCD_MockTypeDef*)ctx;
+    
+    mock->pending = 0;
+    return LCD_OK;
+}
@@ -0,0 +1,63 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_mock.h
+  * @brief          : Host mock transport for the LCD driver
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  */
+
+#ifndef __LCD_MOCK_H
+#define __LCD_MOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "LCD.h"
+
+/* Public defines ------------------------------------------------------------*/
+#ifndef LCD_MOCK_CAPTURE_SIZE
+#define LCD_MOCK_CAPTURE_SIZE   4096
+#endif
+
+/* Public types --------------------------------------------------------------*/
+
+/**
+  * @brief  Records everything written through the mock transports
+  * @note   Pass a pointer to it as the transport ctx
+  */
+typedef struct {
+    uint8_t data[LCD_MOCK_CAPTURE_SIZE];    // First bytes written
+    uint32_t len;                           // Valid bytes in data
+    uint32_t bytes;                         // Total bytes written
+    uint32_t transactions;                  // Number of write/submit calls
+    uint32_t reads;                         // Number of read calls
+    uint8_t last_addr;                      // Address of the last call
+    uint8_t read_value;                     // Byte returned by reads
+    LCD_StatusTypeDef fail_with;            // Result forced on every call
+    uint8_t pending;                        // Submitted write not yet polled
+} LCD_MockTypeDef;
+
+/* Public variables ----------------------------------------------------------*/
+
+// Blocking mock (write, read)
+extern const LCD_TransportTypeDef LCD_Transport_Mock;
+// Asynchronous mock (submit completes on the next poll)
+extern const LCD_TransportTypeDef LCD_Transport_MockAsync;
+
+/* Public function prototypes ------------------------------------------------*/
+
+/**
+  * @brief  Clears captured data and counters
+  * @param  mock: Mock context
+  */
+void LCD_Mock_Reset(LCD_MockTypeDef* mock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LCD_MOCK_H */
@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_sim.c
+  * @brief          : Host simulator for a PCF8574 backpack + HD44780 LCD
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  * The PCF8574 pins use the mapping from LCD.h: P0 = RS, P1 = RW, P2 = EN,
+  * P3 = backlight, P4-P7 = D4-D7. The HD44780 latches D4-D7 on the falling
+  * edge of EN. It starts in 8-bit mode and follows the usual 0x3, 0x3, 0x3,
+  * 0x2 sequence into 4-bit mode. An instruction that arrives while the
+  * controller is still executing the previous one is counted as a violation
+  * and dropped, which is what makes timing bugs visible.
+  */
+
+#include "lcd_sim.h"
+#include "LCD.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define SIM_D_MASK              0xF0
+
+/* Private function prototypes -----------------------------------------------*/
+static void LCD_Sim_Write(void* dev, uint64_t t_us, uint8_t data);
+static uint8_t LCD_Sim_Read(void* dev, uint64_t t_us);
+static void LCD_Sim_Byte(LCD_SimTypeDef* sim, uint64_t t_us, uint8_t rs, uint8_t value);
+static void LCD_Sim_Command(LCD_SimTypeDef* sim, uint64_t t_us, uint8_t cmd);
+static void LCD_Sim_Step(LCD_SimTypeDef* sim, uint8_t forward);
+static uint8_t LCD_Sim_Output(LCD_SimTypeDef* sim, uint64_t t_us);
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  Powers up a simulated display and puts it on the bus
+  * @param  sim: Simulator state
+  * @param  addr: Shifted 8-bit I2C address (e.g. 0x27 << 1)
+  * @param  rows: Visible rows (1-4)
+  * @param  cols: Visible columns (8-40)
+  * @retval HAL_OK, or HAL_ERROR if the bus has no free slot
+  */
+HAL_StatusTypeDef LCD_Sim_Init(LCD_SimTypeDef* sim, uint8_t addr, uint8_t rows, uint8_t cols)
+{
+    HOST_I2CDeviceTypeDef device = { LCD_Sim_Write, LCD_Sim_Read, sim };
+    
+    memset(sim, 0, sizeof(*sim));
+    sim->rows = rows;
+    sim->cols = cols;
+    // Rows 2 and 3 of 4-line modules continue rows 0 and 1
+    sim->row_offsets[0] = 0x00;
+    sim->row_offsets[1] = 0x40;
+    sim->row_offsets[2] = cols;
+    sim->row_offsets[3] = 0x40 + cols;
+    
+    // Power-on reset state: 8-bit, 1 line, display off, increment
+    memset(sim->ddram, ' ', sizeof(sim->ddram));
+    sim->entry_mode = LCD_ENTRY_MODE_SET | LCD_ENTRY_LEFT;
+    sim->display_ctrl = LCD_DISPLAY_CONTROL;
+    sim->function = LCD_FUNCTION_SET | LCD_8BIT_MODE;
+    sim->power_on_us = HOST_GetMicros();
+    sim->busy_until_us = sim->power_on_us + LCD_SIM_POWER_ON_US;
+    
+    return HOST_AttachI2C(addr, &device);
+}
+
+/**
+  * @brief  Copies one visible row (display shift applied) as a C string
+  * @note   CGRAM characters 0-7 are shown as '0'-'7'
+  * @param  sim: Simulator state
+  * @param  row: Row number
+  * @param  buf: Destination, at least cols + 1 bytes
+  */
+void LCD_Sim_GetRow(const LCD_SimTypeDef* sim, uint8_t row, char* buf)
+{
+    uint8_t line_base = sim->row_offsets[row] & 0x40;
+    uint8_t start = sim->row_offsets[row] & 0x3F;
+    
+    for (uint8_t col = 0; col < sim->cols; col++) {
+        uint8_t c = sim->ddram[line_base + (start + col + sim->shift) % 40];
+        buf[col] = (c < 8) ? (char)('0' + c) : (char)c;
+    }
+    buf[sim->cols] = '\0';
+}
+
+/**
+  * @brief  Prints the visible screen in a frame
+  * @param  sim: Simulator state
+  * @param  out: Output stream
+  */
+void LCD_Sim_Print(const LCD_SimTypeDef* sim, FILE* out)
+{
+    char line[41];
+    
+    fputc('+', out);
+    for (uint8_t col = 0; col < sim->cols; col++) fputc('-', out);
+    fputs("+\n", out);
+    
+    for (uint8_t row = 0; row < sim->rows; row++) {
+        LCD_Sim_GetRow(sim, row, line);
+        fprintf(out, "|%s|\n", (sim->display_ctrl & LCD_DISPLAY_ON) ? line : "");
+    }
+    
+    fputc('+', out);
+    for (uint8_t col = 0; col < sim->cols; col++) fputc('-', out);
+    fputs("+\n", out);
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  PCF8574 output update; EN falling edges clock the HD44780
+  */
+static void LCD_Sim_Write(void* dev, uint64_t t_us, uint8_t data)
+{
+    LCD_SimTypeDef* sim = (LCD_SimTypeDef*)dev;
+    
+    if (sim->rw_grounded) {
+        data &= ~LCD_RW;  // Reads turn into writes, D4-D7 read back high
+    }
+    
+    uint8_t falling = (sim->pins & LCD_EN) && !(data & LCD_EN);
+    uint8_t rs = sim->pins & LCD_RS;
+    uint8_t rw = sim->pins & LCD_RW;
+    uint8_t d = sim->pins & SIM_D_MASK;  // Sampled while EN was high
+    
+    sim->pins = data;
+    
+    if (!falling) {
+        return;
+    }
+    
+    if (rw) {
+        // Read cycle: the second nibble completes the byte
+        if (sim->four_bit) {
+            sim->read_nibble ^= 1;
+            if (!sim->read_nibble && rs) {
+                LCD_Sim_Step(sim, sim->entry_mode & LCD_ENTRY_LEFT);
+            }
+        } else if (rs) {
+            LCD_Sim_Step(sim, sim->entry_mode & LCD_ENTRY_LEFT);
+        }
+        return;
+    }
+    
+    sim->read_nibble = 0;
+    
+    if (!sim->four_bit) {
+        // 8-bit interface: D0-D3 are not wired and read as 0
+        LCD_Sim_Byte(sim, t_us, rs, d);
+        return;
+    }
+    
+    if (!sim->nibble) {
+        sim->latch = d;
+        sim->nibble = 1;
+    } else {
+        sim->nibble = 0;
+        LCD_Sim_Byte(sim, t_us, rs, sim->latch | (d >> 4));
+    }
+}
+
+/**
+  * @brief  PCF8574 input: D4-D7 are driven by the HD44780 during reads
+  */
+static uint8_t LCD_Sim_Read(void* dev, uint64_t t_us)
+{
+    LCD_SimTypeDef* sim = (LCD_SimTypeDef*)dev;
+    uint8_t value = sim->pins;
+    
+    if ((sim->pins & LCD_RW) && (sim->pins & LCD_EN)) {
+        uint8_t out = LCD_Sim_Output(sim, t_us);
+        if (sim->four_bit && sim->read_nibble) {
+            out <<= 4;
+        }
+        value = (value & ~SIM_D_MASK) | (out & SIM_D_MASK);
+    }
+    
+    return value;
+}
+
+/**
+  * @brief  Byte the HD44780 drives for a read (busy flag/AC or data)
+  */
+static uint8_t LCD_Sim_Output(LCD_SimTypeDef* sim, uint64_t t_us)
+{
+    if (sim->pins & LCD_RS) {
+        return sim->ac_cgram ? sim->cgram[sim->ac & 0x3F] : sim->ddram[sim->ac & 0x7F];
+    }
+    
+    return ((t_us < sim->busy_until_us) ? 0x80 : 0x00) | (sim->ac & 0x7F);
+}
+
+/**
+  * @brief  Executes one complete instruction or data write
+  */
+static void LCD_Sim_Byte(LCD_SimTypeDef* sim, uint64_t t_us, uint8_t rs, uint8_t value)
+{
+    if (t_us < sim->busy_until_us) {
+        sim->violations++;
+        return;
+    }
+    
+    if (!rs) {
+        LCD_Sim_Command(sim, t_us, value);
+        return;
+    }
+    
+    sim->writes++;
+    if (sim->ac_cgram) {
+        sim->cgram[sim->ac & 0x3F] = value;
+    } else {
+        sim->ddram[sim->ac & 0x7F] = value;
+        if (sim->entry_mode & LCD_ENTRY_SHIFT_INC) {
+            // Display follows the cursor
+            uint8_t left = sim->entry_mode & LCD_ENTRY_LEFT;
+            sim->shift = (sim->shift + (left ? 1 : 39)) % 40;
+        }
+    }
+    LCD_Sim_Step(sim, sim->entry_mode & LCD_ENTRY_LEFT);
+    sim->busy_until_us = t_us + LCD_SIM_EXEC_US;
+}
+
+/**
+  * @brief  Executes one instruction
+  */
+static void LCD_Sim_Command(LCD_SimTypeDef* sim, uint64_t t_us, uint8_t cmd)
+{
+    uint32_t exec_us = LCD_SIM_EXEC_US;
+    
+    sim->instructions++;
+    
+    if (cmd & LCD_SET_DDRAM_ADDR) {
+        sim->ac = cmd & 0x7F;
+        sim->ac_cgram = 0;
+    } else if (cmd & LCD_SET_CGRAM_ADDR) {
+        sim->ac = cmd & 0x3F;
+        sim->ac_cgram = 1;
+    } else if (cmd & LCD_FUNCTION_SET) {
+        if (!sim->four_bit && sim->init_step < 3 && (cmd & LCD_8BIT_MODE)) {
+            // Power-on sequence: first wait 4.1 ms, then 100 us
+            exec_us = (sim->init_step == 0) ? 4100 : 100;
+            sim->init_step++;
+        }
+        sim->four_bit = !(cmd & LCD_8BIT_MODE);
+        sim->nibble = 0;
+        sim->function = cmd;
+    } else if (cmd & LCD_CURSOR_SHIFT) {
+        if (cmd & LCD_DISPLAY_MOVE) {
+            sim->shift = (sim->shift + ((cmd & LCD_MOVE_RIGHT) ? 39 : 1)) % 40;
+        } else {
+            LCD_Sim_Step(sim, cmd & LCD_MOVE_RIGHT);
+        }
+    } else if (cmd & LCD_DISPLAY_CONTROL) {
+        sim->display_ctrl = cmd;
+    } else if (cmd & LCD_ENTRY_MODE_SET) {
+        sim->entry_mode = cmd;
+    } else if (cmd & LCD_RETURN_HOME) {
+        sim->ac = 0;
+        sim->ac_cgram = 0;
+        sim->shift = 0;
+        exec_us = LCD_SIM_CLEAR_US;
+    } else if (cmd & LCD_CLEAR_DISPLAY) {
+        memset(sim->ddram, ' ', sizeof(sim->ddram));
+        sim->ac = 0;
+        sim->ac_cgram = 0;
+        sim->shift = 0;
+        sim->entry_mode |= LCD_ENTRY_LEFT;
+        exec_us = LCD_SIM_CLEAR_US;
+    }
+    
+    sim->busy_until_us = t_us + exec_us;
+}
+
+/**
+  * @brief  Moves the address counter by one
+  * @param  forward: Non-zero to increment
+  */
+static void LCD_Sim_Step(LCD_SimTypeDef* sim, uint8_t forward)
+{
+    if (sim->ac_cgram) {
+        sim->ac = (sim->ac + (forward ? 1 : 63)) & 0x3F;
+    } else if (!(sim->function & LCD_2LINE)) {
+        sim->ac = (sim->ac + (forward ? 1 : 79)) % 80;
+    } else if (forward) {
+        sim->ac = (sim->ac == 0x27) ? 0x40 : (sim->ac == 0x67) ? 0x00 : sim->ac + 1;
+    } else {
+        sim->ac = (sim->ac == 0x40) ? 0x27 : (sim->ac == 0x00) ? 0x67 : sim->ac - 1;
+    }
+}
@@ -0,0 +1,100 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_sim.h
+  * @brief          : Host simulator for a PCF8574 backpack + HD44780 LCD
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  */
+
+#ifndef __LCD_SIM_H
+#define __LCD_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include "stm32c0xx_hal.h"
+
+/* Public defines ------------------------------------------------------------*/
+
+// HD44780 execution times (270 kHz oscillator)
+#define LCD_SIM_EXEC_US         37      // Most instructions
+#define LCD_SIM_CLEAR_US        1520    // Clear display, return home
+#define LCD_SIM_POWER_ON_US     40000   // From power-on to first instruction
+
+/* Public types --------------------------------------------------------------*/
+
+/**
+  * @brief  State of one simulated display
+  */
+typedef struct {
+    // Geometry of the glass
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t row_offsets[4];
+    
+    // PCF8574
+    uint8_t pins;                       // Last byte written
+    uint8_t rw_grounded;                // 1 if the backpack ties RW to ground
+    
+    // HD44780
+    uint8_t ddram[0x80];
+    uint8_t cgram[64];
+    uint8_t ac;                         // Address counter
+    uint8_t ac_cgram;                   // 1 if ac points into CGRAM
+    uint8_t four_bit;                   // Interface data length
+    uint8_t nibble;                     // Next nibble is the low one
+    uint8_t latch;                      // High nibble of the current byte
+    uint8_t read_nibble;                // Next read returns the low nibble
+    uint8_t entry_mode;
+    uint8_t display_ctrl;
+    uint8_t function;
+    uint8_t shift;                      // Display shift, 0-39
+    uint8_t init_step;                  // Power-on function sets seen
+    uint64_t power_on_us;
+    uint64_t busy_until_us;
+    
+    // Statistics
+    uint32_t instructions;              // Commands executed
+    uint32_t writes;                    // Data bytes written
+    uint32_t violations;                // Instructions lost while busy
+} LCD_SimTypeDef;
+
+/* Public function prototypes ------------------------------------------------*/
+
+/**
+  * @brief  Powers up a simulated display and puts it on the bus
+  * @param  sim: Simulator state
+  * @param  addr: Shifted 8-bit I2C address (e.g. 0x27 << 1)
+  * @param  rows: Visible rows (1-4)
+  * @param  cols: Visible columns (8-40)
+  * @retval HAL_OK, or HAL_ERROR if the bus has no free slot
+  */
+HAL_StatusTypeDef LCD_Sim_Init(LCD_SimTypeDef* sim, uint8_t addr, uint8_t rows, uint8_t cols);
+
+/**
+  * @brief  Copies one visible row (display shift applied) as a C string
+  * @note   CGRAM characters 0-7 are shown as '0'-'7'
+  * @param  sim: Simulator state
+  * @param  row: Row number
+  * @param  buf: Destination, at least cols + 1 bytes
+  */
+void LCD_Sim_GetRow(const LCD_SimTypeDef* sim, uint8_t row, char* buf);
+
+/**
+  * @brief  Prints the visible screen in a frame
+  * @param  sim: Simulator state
+  * @param  out: Output stream
+  */
+void LCD_Sim_Print(const LCD_SimTypeDef* sim, FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LCD_SIM_H */
@@ -0,0 +1,707 @@
+/**
+  ******************************************************************************
+  * @file           : lcd_test.c
+  * @brief          : Regression tests of the LCD driver against the simulator
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  * Drives the public API against simulated displays and checks what ends up
+  * on the glass (LCD_Sim_GetRow) and that no instruction reached a busy
+  * controller (violations == 0). Prints one line per failed check and exits
+  * with 1 if any failed.
+  *
+  *   gcc -I. -Ihost LCD.c host/stm32c0xx_hal.c host/lcd_sim.c \
+  *       host/lcd_mock.c host/lcd_test.c -o lcd_test && ./lcd_test
+  *
+  * Driver options are -D flags; run it for every configuration that ships:
+  *
+  *   for cfg in "" "-DLCD_TRANSPORT=1" "-DLCD_TRANSPORT=2" \
+  *              "-DLCD_USE_FRAMEBUFFER=1" "-DLCD_USE_FRAMEBUFFER=1 -DLCD_TRANSPORT=2" \
+  *              "-DLCD_TIMING_MODE=1" "-DLCD_USE_BUSY_FLAG=1" \
+  *              "-DLCD_GEOMETRY=LCD_GEOMETRY_16x2 -DLCD_FIXED_GEOMETRY=1"; do
+  *       gcc -I. -Ihost $cfg LCD.c host/stm32c0xx_hal.c host/lcd_sim.c \
+  *           host/lcd_mock.c host/lcd_test.c -o lcd_test && ./lcd_test || echo "FAILED: $cfg"
+  *   done
+  */
+
+#include "LCD.h"
+#include "lcd_sim.h"
+#include "lcd_mock.h"
+#include <stdio.h>
+#include <string.h>
+
+#if (LCD_ROWS < 2) || (LCD_COLS < 16)
+#error "lcd_test needs at least 2 rows of 16 columns"
+#endif
+
+/* Private defines -----------------------------------------------------------*/
+#define TEST_ADDR               (0x27 << 1)
+#define TEST_ADDR_2             (0x26 << 1)
+#define TEST_WAIT_MS            1000
+#define TEST_FLUSH_TRIES        8
+#define TEST_AC_UNKNOWN         0xFF    // hlcd->ac when not tracked
+
+// Records a failed check with its source line
+#define TEST_CHECK(cond) do { \
+    test_checks++; \
+    if (!(cond)) { \
+        test_failures++; \
+        printf("%s:%d: %s: check failed: %s\n", __FILE__, __LINE__, test_name, #cond); \
+    } \
+} while(0)
+
+// Checks the start of a simulated row
+#define TEST_ROW(sim, row, text) \
+    TEST_CHECK(TEST_RowIs((sim), (row), (text)))
+
+/* Private types -------------------------------------------------------------*/
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} TEST_CaseTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static LCD_SimTypeDef test_sim;
+static LCD_SimTypeDef test_sim_2;
+static I2C_HandleTypeDef test_hi2c;
+static LCD_HandleTypeDef test_lcd;
+static LCD_HandleTypeDef test_lcd_2;
+static LCD_MockTypeDef test_mock;
+
+static const char* test_name = "";
+static uint32_t test_checks = 0;
+static uint32_t test_failures = 0;
+
+static const uint8_t test_bell[8] = { 0x04, 0x0E, 0x0E, 0x0E, 0x1F, 0x00, 0x04, 0x00 };
+
+// "AB" on the expander pins: high nibble with EN, without EN, then the low
+// nibble; RS and backlight set on every byte
+static const uint8_t test_stream_ab[] = {
+    0x4D, 0x49, 0x1D, 0x19,
+#if LCD_USE_BUSY_FLAG && (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+    0xFA, 0xFE, 0xFA, 0xFE, 0xFA,       // Busy flag poll after each character
+#endif
+    0x4D, 0x49, 0x2D, 0x29,
+#if LCD_USE_BUSY_FLAG && (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+    0xFA, 0xFE, 0xFA, 0xFE, 0xFA,
+#endif
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Compares the start of a simulated row with a string
+  * @retval 1 if the row starts with text, 0 otherwise (row is printed)
+  */
+static uint8_t TEST_RowIs(const LCD_SimTypeDef* sim, uint8_t row, const char* text)
+{
+    char shown[41];
+    
+    LCD_Sim_GetRow(sim, row, shown);
+    if (strncmp(shown, text, strlen(text)) != 0) {
+        printf("  row %u: \"%s\", expected \"%s\"\n", row, shown, text);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+  * @brief  Powers up a fresh simulator and initializes the test handle on it
+  */
+static void TEST_Setup(void)
+{
+    memset(&test_lcd, 0, sizeof(test_lcd));
+    LCD_Sim_Init(&test_sim, TEST_ADDR, LCD_ROWS, LCD_COLS);
+    TEST_CHECK(LCDx_Init(&test_lcd, &test_hi2c, TEST_ADDR) == LCD_OK);
+}
+
+/**
+  * @brief  Brings a display up to date: flushes the framebuffer (in parts if
+  *         the queue is full) and waits until everything is on the wire
+  */
+static void TEST_Sync(LCD_HandleTypeDef* hlcd)
+{
+#if LCD_USE_FRAMEBUFFER
+    uint8_t tries = 0;
+    LCD_StatusTypeDef status;
+    
+    while ((status = LCDx_Flush(hlcd)) == LCD_BUSY && ++tries < TEST_FLUSH_TRIES) {
+        LCDx_WaitIdle(hlcd, TEST_WAIT_MS);
+    }
+    TEST_CHECK(status == LCD_OK);
+#endif
+    TEST_CHECK(LCDx_WaitIdle(hlcd, TEST_WAIT_MS) == LCD_OK);
+}
+
+/**
+  * @brief  Strings and integers at explicit positions
+  */
+static void TEST_PrintString(void)
+{
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Hello");
+    LCDx_SetCursor(&test_lcd, 1, 2);
+    LCDx_PrintInt(&test_lcd, -42);
+    TEST_Sync(&test_lcd);
+    
+    TEST_ROW(&test_sim, 0, "Hello ");
+    TEST_ROW(&test_sim, 1, "  -42 ");
+    
+    // Overwrite in the middle of a row
+    LCDx_SetCursor(&test_lcd, 0, 1);
+    LCDx_PrintString(&test_lcd, "ELL");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "HELLo ");
+    
+    // Cursor position comes from the tracked address counter
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_PrintString(&test_lcd, "ab");
+    LCDx_PrintString(&test_lcd, "cd");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 1, "abcd2 ");
+}
+
+/**
+  * @brief  Formatted output
+  */
+static void TEST_Printf(void)
+{
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_Printf(&test_lcd, "%5d|%-3s|%x", 42, "ab", 255);
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_Printf(&test_lcd, "%03u %c %.1f%%", 7u, 'Z', 2.5);
+    TEST_Sync(&test_lcd);
+    
+    TEST_ROW(&test_sim, 0, "   42|ab |ff ");
+    TEST_ROW(&test_sim, 1, "007 Z 2.5% ");
+    
+    LCDx_Clear(&test_lcd);
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintFloat(&test_lcd, 3.14159f, 2);
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_PrintFloat(&test_lcd, -0.5f, 1);
+    TEST_Sync(&test_lcd);
+    
+    TEST_ROW(&test_sim, 0, "3.14 ");
+    TEST_ROW(&test_sim, 1, "-0.5 ");
+    
+    // long arguments, and a precision that would wrap a uint8_t to 0
+    LCDx_Clear(&test_lcd);
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_Printf(&test_lcd, "%ld %lx %d", -123456L, 0xBEEFUL, 9);
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_Printf(&test_lcd, "%.256f", 2.5);
+    TEST_Sync(&test_lcd);
+    
+    TEST_ROW(&test_sim, 0, "-123456 beef 9 ");
+    TEST_ROW(&test_sim, 1, "2.500000 ");
+}
+
+/**
+  * @brief  Numeric fields only rewrite what changed and keep their width
+  */
+static void TEST_Field(void)
+{
+    LCD_FieldTypeDef field;
+    LCD_FieldTypeDef left;
+    LCD_HandleTypeDef blank;
+    
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_PrintString(&test_lcd, "T=");
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, &field, 1, 2, 5, LCD_ALIGN_RIGHT, ' ', 1) == LCD_OK);
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, &left, 0, 0, 4, LCD_ALIGN_LEFT, '.', 0) == LCD_OK);
+    
+    LCDx_FieldUpdate(&test_lcd, &field, 12345);
+    LCDx_FieldUpdate(&test_lcd, &left, 7);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 1, "T=12345 ");
+    TEST_ROW(&test_sim, 0, "7... ");
+    
+    LCDx_FieldUpdate(&test_lcd, &field, -7);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 1, "T=   -7 ");
+    
+    // Row past the last one
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, &field, LCD_ROWS, 0, 5, LCD_ALIGN_RIGHT, ' ', 1) ==
+               LCD_ERROR);
+    
+    // Zero padding on the right would read as a bigger number
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, &left, 0, 0, 4, LCD_ALIGN_LEFT, '0', 0) == LCD_ERROR);
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, &field, 1, 2, 5, LCD_ALIGN_RIGHT, '0', 1) == LCD_OK);
+    LCDx_FieldUpdate(&test_lcd, &field, -7);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 1, "T=-0007 ");
+    
+    // Missing handle or field
+    TEST_CHECK(LCDx_FieldInit(NULL, &field, 0, 0, 5, LCD_ALIGN_RIGHT, ' ', 1) ==
+               LCD_NOT_INITIALIZED);
+    TEST_CHECK(LCDx_FieldInit(&test_lcd, NULL, 0, 0, 5, LCD_ALIGN_RIGHT, ' ', 1) == LCD_ERROR);
+    TEST_CHECK(LCDx_FieldUpdate(NULL, &field, 1) == LCD_NOT_INITIALIZED);
+    
+    // Handle never passed to LCDx_Init
+    memset(&blank, 0, sizeof(blank));
+    TEST_CHECK(LCDx_FieldInit(&blank, &field, 0, 0, 5, LCD_ALIGN_RIGHT, ' ', 1) ==
+               LCD_NOT_INITIALIZED);
+    TEST_CHECK(LCDx_FieldUpdate(&blank, &field, 1) == LCD_NOT_INITIALIZED);
+    TEST_CHECK(LCDx_FieldUpdate(&test_lcd, NULL, 1) == LCD_ERROR);
+}
+
+/**
+  * @brief  Custom characters: upload, show, read back
+  */
+static void TEST_CustomChar(void)
+{
+    uint8_t bell[8];
+    uint8_t got[8];
+    
+    TEST_Setup();
+    memcpy(bell, test_bell, sizeof(bell));
+    TEST_CHECK(LCDx_CreateChar(&test_lcd, 1, bell) == LCD_OK);
+    LCDx_SetCursor(&test_lcd, 0, 3);
+    LCDx_WriteChar(&test_lcd, 1);
+    TEST_Sync(&test_lcd);
+    
+    TEST_ROW(&test_sim, 0, "   1 ");
+    TEST_CHECK(memcmp(&test_sim.cgram[8], test_bell, 8) == 0);
+    TEST_CHECK(LCDx_ReadChar(&test_lcd, 1, got) == LCD_OK);
+    TEST_CHECK(memcmp(got, test_bell, 8) == 0);
+    
+    // After a CGRAM access the cursor must be set again; it is not skipped
+    LCDx_SetCursor(&test_lcd, 0, 4);
+    LCDx_PrintString(&test_lcd, "x");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "   1x ");
+}
+
+/**
+  * @brief  Clear, home, scrolling and the display/cursor registers
+  */
+static void TEST_Control(void)
+{
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "ABCDEF");
+    TEST_Sync(&test_lcd);
+    
+    LCDx_ScrollLeft(&test_lcd);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "BCDEF ");
+    LCDx_ScrollRight(&test_lcd);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "ABCDEF ");
+    
+    LCDx_Cursor(&test_lcd, 1);
+    LCDx_Blink(&test_lcd, 1);
+    TEST_Sync(&test_lcd);
+    TEST_CHECK((test_sim.display_ctrl & (LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_ON)) ==
+               (LCD_DISPLAY_ON | LCD_CURSOR_ON | LCD_BLINK_ON));
+    LCDx_Cursor(&test_lcd, 0);
+    LCDx_Blink(&test_lcd, 0);
+    
+    LCDx_Clear(&test_lcd);
+    LCDx_PrintString(&test_lcd, "Z");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Z     ");
+    
+    LCDx_Home(&test_lcd);
+    LCDx_PrintString(&test_lcd, "Y");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Y     ");
+}
+
+/**
+  * @brief  Rows 2 and 3 of 4-line modules and text clipped at the last column
+  */
+static void TEST_Geometry(void)
+{
+    char line[LCD_COLS + 1];
+    
+    TEST_Setup();
+    memset(line, '#', LCD_COLS);
+    line[LCD_COLS] = '\0';
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        line[0] = (char)('0' + row);
+        LCDx_SetCursor(&test_lcd, row, 0);
+        LCDx_PrintString(&test_lcd, line);
+        TEST_Sync(&test_lcd);
+    }
+    for (uint8_t row = 0; row < LCD_ROWS; row++) {
+        line[0] = (char)('0' + row);
+        TEST_ROW(&test_sim, row, line);
+    }
+    
+    // The last cell of the last row
+    LCDx_SetCursor(&test_lcd, LCD_ROWS - 1, LCD_COLS - 1);
+    LCDx_PrintString(&test_lcd, "!");
+    TEST_Sync(&test_lcd);
+    line[0] = (char)('0' + LCD_ROWS - 1);
+    line[LCD_COLS - 1] = '!';
+    TEST_ROW(&test_sim, LCD_ROWS - 1, line);
+    
+#if LCD_USE_FRAMEBUFFER
+    // A new geometry blanks the framebuffer; the flush must clear the glass
+    TEST_CHECK(LCDx_SetGeometry(&test_lcd, LCD_ROWS, LCD_COLS) == LCD_OK);
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Hi");
+    TEST_Sync(&test_lcd);
+    memset(line, ' ', LCD_COLS);
+    line[0] = 'H';
+    line[1] = 'i';
+    TEST_ROW(&test_sim, 0, line);
+    line[0] = ' ';
+    line[1] = ' ';
+    for (uint8_t row = 1; row < LCD_ROWS; row++) {
+        TEST_ROW(&test_sim, row, line);
+    }
+#endif
+}
+
+#if LCD_USE_FRAMEBUFFER
+/**
+  * @brief  Flush planning: nothing is sent for an unchanged screen, and one
+  *         changed cell costs a set-address command plus the character
+  */
+static void TEST_FlushPlan(void)
+{
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Frame one");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) > 0);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Frame one ");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) == 0);
+    
+    // Same text again: no change
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Frame one");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) == 0);
+    
+    // Changed and written back: dirty but nothing to send, and planning
+    // leaves the row as it is
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "X");
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "F");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) == 0);
+    TEST_CHECK(test_lcd.fb_dirty & 1);
+    
+    LCDx_SetCursor(&test_lcd, 0, 8);
+    LCDx_PrintString(&test_lcd, "2");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) <= 2 * 4 + 2 * 4);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Frame on2 ");
+    
+    // Clear only blanks the cells that were not blank
+    LCDx_Clear(&test_lcd);
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "          ");
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) == 0);
+}
+#endif
+
+/**
+  * @brief  Reading DDRAM back
+  */
+static void TEST_ReadBack(void)
+{
+    uint8_t row[LCD_COLS];
+    
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_PrintString(&test_lcd, "Read me");
+    TEST_Sync(&test_lcd);
+    
+    TEST_CHECK(LCDx_ReadRow(&test_lcd, 1, row) == LCD_OK);
+    TEST_CHECK(memcmp(row, "Read me ", 8) == 0);
+    
+#if LCD_USE_FRAMEBUFFER
+    // A framebuffer loaded from the glass has nothing to send
+    TEST_CHECK(LCDx_ReadBack(&test_lcd) == LCD_OK);
+    TEST_CHECK(LCDx_FlushPlan(&test_lcd) == 0);
+    TEST_CHECK(memcmp(test_lcd.fb[1], "Read me ", 8) == 0);
+#endif
+    
+    // Drawing continues at the tracked position after the reads
+    LCDx_SetCursor(&test_lcd, 1, 5);
+    LCDx_PrintString(&test_lcd, "ME");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 1, "Read ME ");
+}
+
+/**
+  * @brief  Attaching to a display that is already set up keeps its contents
+  */
+static void TEST_InitWarm(void)
+{
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Before reset");
+    TEST_Sync(&test_lcd);
+    uint32_t instructions = test_sim.instructions;
+    
+    // MCU reset: the handle is gone, the controller is not
+    TEST_CHECK(LCDx_DeInit(&test_lcd) == LCD_OK);
+    memset(&test_lcd, 0, sizeof(test_lcd));
+    TEST_CHECK(LCDx_InitWarm(&test_lcd, &test_hi2c, TEST_ADDR) == LCD_OK);
+    TEST_CHECK(LCDx_WaitIdle(&test_lcd, TEST_WAIT_MS) == LCD_OK);
+    TEST_ROW(&test_sim, 0, "Before reset");
+    TEST_CHECK(test_sim.instructions - instructions < 8);  // No clear, no init sequence
+    
+    // In framebuffer mode the first flush must keep what was read back
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    LCDx_PrintString(&test_lcd, "After");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Before reset");
+    TEST_ROW(&test_sim, 1, "After ");
+}
+
+/**
+  * @brief  Same text and custom character on two displays
+  */
+static void TEST_Broadcast(void)
+{
+    LCD_HandleTypeDef* const both[] = { &test_lcd, &test_lcd_2 };
+    
+    TEST_Setup();
+    memset(&test_lcd_2, 0, sizeof(test_lcd_2));
+    LCD_Sim_Init(&test_sim_2, TEST_ADDR_2, LCD_ROWS, LCD_COLS);
+    TEST_CHECK(LCDx_Init(&test_lcd_2, &test_hi2c, TEST_ADDR_2) == LCD_OK);
+    
+    TEST_CHECK(LCD_BroadcastChar(both, 2, 2, test_bell) == LCD_OK);
+    TEST_CHECK(LCD_BroadcastString(both, 2, 1, 3, "ALARM") == LCD_OK);
+    LCDx_SetCursor(&test_lcd, 1, 8);
+    LCDx_WriteChar(&test_lcd, 2);
+    TEST_Sync(&test_lcd);
+    TEST_Sync(&test_lcd_2);
+    
+    TEST_ROW(&test_sim, 1, "   ALARM2 ");
+    TEST_ROW(&test_sim_2, 1, "   ALARM ");
+    TEST_CHECK(memcmp(&test_sim.cgram[16], test_bell, 8) == 0);
+    TEST_CHECK(memcmp(&test_sim_2.cgram[16], test_bell, 8) == 0);
+    TEST_CHECK(test_sim_2.violations == 0);
+    
+#if !LCD_USE_FRAMEBUFFER
+    // Continues where the last broadcast left both counters: no Set DDRAM
+    LCDx_SetCursor(&test_lcd, 1, 8);
+    uint32_t instructions = test_sim.instructions;
+    uint32_t instructions_2 = test_sim_2.instructions;
+    TEST_CHECK(LCD_BroadcastString(both, 2, 1, 8, "!") == LCD_OK);
+    TEST_Sync(&test_lcd);
+    TEST_Sync(&test_lcd_2);
+    TEST_ROW(&test_sim, 1, "   ALARM! ");
+    TEST_ROW(&test_sim_2, 1, "   ALARM! ");
+    TEST_CHECK(test_sim.instructions == instructions);
+    TEST_CHECK(test_sim_2.instructions == instructions_2);
+#endif
+    
+    LCDx_DeInit(&test_lcd_2);
+}
+
+/**
+  * @brief  Exact expander byte stream through the mock transports
+  */
+static void TEST_MockStream(void)
+{
+    const LCD_TransportTypeDef* transports[] = {
+        &LCD_Transport_Mock,
+#if (LCD_TIMING_MODE != LCD_TIMING_DELAY)
+        &LCD_Transport_MockAsync,
+#endif
+    };
+    uint8_t count = sizeof(transports) / sizeof(transports[0]);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        memset(&test_lcd, 0, sizeof(test_lcd));
+        LCD_Mock_Reset(&test_mock);
+        TEST_CHECK(LCDx_InitTransport(&test_lcd, transports[i], &test_mock, TEST_ADDR) == LCD_OK);
+        TEST_CHECK(LCDx_WaitIdle(&test_lcd, TEST_WAIT_MS) == LCD_OK);
+        
+        // Cursor is at 0,0 after init: no Set DDRAM, just the characters
+        LCD_Mock_Reset(&test_mock);
+        TEST_CHECK(LCDx_PrintString(&test_lcd, "AB") == LCD_OK);
+        TEST_Sync(&test_lcd);
+        TEST_CHECK(test_mock.last_addr == TEST_ADDR);
+        TEST_CHECK(test_mock.len == sizeof(test_stream_ab));
+        TEST_CHECK(memcmp(test_mock.data, test_stream_ab, sizeof(test_stream_ab)) == 0);
+        TEST_CHECK(test_mock.pending == 0);
+        
+        LCDx_DeInit(&test_lcd);
+    }
+    
+    // A failing blocking transport reaches the caller
+    memset(&test_lcd, 0, sizeof(test_lcd));
+    LCD_Mock_Reset(&test_mock);
+    TEST_CHECK(LCDx_InitTransport(&test_lcd, &LCD_Transport_Mock, &test_mock, TEST_ADDR) == LCD_OK);
+    test_mock.fail_with = LCD_ERROR;
+#if LCD_USE_FRAMEBUFFER
+    LCDx_PrintString(&test_lcd, "C");
+    TEST_CHECK(LCDx_Flush(&test_lcd) == LCD_ERROR);
+#else
+    TEST_CHECK(LCDx_PrintString(&test_lcd, "C") == LCD_ERROR);
+#endif
+    test_mock.fail_with = LCD_OK;
+}
+
+/**
+  * @brief  Address tracking survives a failed transfer and a full queue
+  */
+static void TEST_Recovery(void)
+{
+    // One failed transfer: registers are sent again, tracking goes on
+    memset(&test_lcd, 0, sizeof(test_lcd));
+    LCD_Mock_Reset(&test_mock);
+    TEST_CHECK(LCDx_InitTransport(&test_lcd, &LCD_Transport_Mock, &test_mock, TEST_ADDR) == LCD_OK);
+    test_mock.fail_with = LCD_ERROR;
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "C");
+#if LCD_USE_FRAMEBUFFER
+    TEST_CHECK(LCDx_Flush(&test_lcd) == LCD_ERROR);
+#endif
+    test_mock.fail_with = LCD_OK;
+    
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "AB");
+    TEST_Sync(&test_lcd);
+    TEST_CHECK(test_lcd.stale == 0);
+    TEST_CHECK(test_lcd.ac == 2);
+#if !LCD_USE_FRAMEBUFFER
+    uint32_t len = test_mock.len;
+    TEST_CHECK(LCDx_SetCursor(&test_lcd, 0, 2) == LCD_OK);
+    TEST_CHECK(test_mock.len == len);  // Counter already there
+#endif
+    LCDx_DeInit(&test_lcd);
+    
+#if !LCD_USE_FRAMEBUFFER && (LCD_TIMING_MODE != LCD_TIMING_DELAY)
+    // Queue overflow: the dropped operation leaves the shadows as they were
+    memset(&test_lcd, 0, sizeof(test_lcd));
+    LCD_Mock_Reset(&test_mock);
+    TEST_CHECK(LCDx_InitTransport(&test_lcd, &LCD_Transport_MockAsync, &test_mock, TEST_ADDR) ==
+               LCD_OK);
+    TEST_CHECK(LCDx_WaitIdle(&test_lcd, TEST_WAIT_MS) == LCD_OK);
+    LCDx_SetCursor(&test_lcd, 1, 0);
+    
+    LCD_StatusTypeDef status = LCD_OK;
+    uint8_t before = TEST_AC_UNKNOWN;
+    for (uint8_t i = 0; i < 32 && status == LCD_OK; i++) {
+        before = test_lcd.ac;
+        status = LCDx_PrintString(&test_lcd, "0123456789");  // Nothing drains the queue
+    }
+    TEST_CHECK(status == LCD_BUSY);
+    TEST_CHECK(before != TEST_AC_UNKNOWN);
+    TEST_CHECK(test_lcd.ac == before);
+    TEST_CHECK(test_lcd.stale == 0);
+    
+    TEST_CHECK(LCDx_WaitIdle(&test_lcd, TEST_WAIT_MS) == LCD_OK);
+    TEST_CHECK(LCDx_PrintString(&test_lcd, "0123456789") == LCD_OK);
+    TEST_CHECK(test_lcd.ac != TEST_AC_UNKNOWN);
+    LCDx_DeInit(&test_lcd);
+#endif
+}
+
+#if LCD_USE_BUSY_FLAG && (LCD_TRANSPORT == LCD_TRANSPORT_BLOCKING)
+/**
+  * @brief  Busy flag polls on a backpack with RW tied to ground
+  * @note   From the moment rw_grounded is set, every poll is written as
+  *         0xFF (Set DDRAM 0x7F) until the driver gives up on the flag.
+  *         With LCD_TIMING_DELAY every byte polls, so the fallback hits
+  *         the operation that follows; with LCD_TIMING_BUS only clear and
+  *         home poll.
+  */
+static void TEST_BusyFallback(void)
+{
+    // Fallback on a set-address: the text still lands at row 1, col 3
+    TEST_Setup();
+    test_sim.rw_grounded = 1;
+    LCDx_SetCursor(&test_lcd, 1, 3);
+    LCDx_PrintString(&test_lcd, "abc");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "    ");
+    TEST_ROW(&test_sim, 1, "   abc ");
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+    TEST_CHECK(test_lcd.busy_flag == 0);
+#endif
+    
+    // Fallback on a data write after a display shift: shift kept
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Hello");
+    TEST_Sync(&test_lcd);
+    LCDx_ScrollLeft(&test_lcd);
+    TEST_Sync(&test_lcd);
+    test_sim.rw_grounded = 1;
+    LCDx_PrintString(&test_lcd, "!");
+    LCDx_PrintString(&test_lcd, "?");
+    TEST_Sync(&test_lcd);
+    TEST_CHECK(test_sim.shift == 1);
+    TEST_ROW(&test_sim, 0, "ello!? ");
+#if (LCD_TIMING_MODE == LCD_TIMING_DELAY)
+    TEST_CHECK(test_lcd.busy_flag == 0);
+#endif
+    
+    // Fallback inside a CGRAM upload: the pattern stays in its slot
+    TEST_Setup();
+    test_sim.rw_grounded = 1;
+    TEST_CHECK(LCDx_CreateChar(&test_lcd, 3, (uint8_t*)test_bell) == LCD_OK);
+    TEST_Sync(&test_lcd);
+    TEST_CHECK(memcmp(&test_sim.cgram[24], test_bell, 8) == 0);
+    
+    // Fallback on home (both timing modes)
+    TEST_Setup();
+    LCDx_SetCursor(&test_lcd, 0, 0);
+    LCDx_PrintString(&test_lcd, "Hi");
+    TEST_Sync(&test_lcd);
+    test_sim.rw_grounded = 1;
+    TEST_CHECK(LCDx_Home(&test_lcd) == LCD_OK);
+    TEST_CHECK(test_lcd.busy_flag == 0);
+    LCDx_PrintString(&test_lcd, "O");
+    LCDx_SetCursor(&test_lcd, 1, 2);
+    LCDx_PrintString(&test_lcd, "k");
+    TEST_Sync(&test_lcd);
+    TEST_ROW(&test_sim, 0, "Oi ");
+    TEST_ROW(&test_sim, 1, "  k ");
+    
+    // Polls sent while the LCD was still busy were lost, by design
+    test_sim.violations = 0;
+}
+#endif
+
+static const TEST_CaseTypeDef test_cases[] = {
+    { "print_string",   TEST_PrintString },
+    { "printf",         TEST_Printf },
+    { "field",          TEST_Field },
+    { "custom_char",    TEST_CustomChar },
+    { "control",        TEST_Control },
+    { "geometry",       TEST_Geometry },
+#if LCD_USE_FRAMEBUFFER
+    { "flush_plan",     TEST_FlushPlan },
+#endif
+    { "read_back",      TEST_ReadBack },
+    { "init_warm",      TEST_InitWarm },
+    { "broadcast",      TEST_Broadcast },
+    { "mock_stream",    TEST_MockStream },
+    { "recovery",       TEST_Recovery },
+#if LCD_USE_BUSY_FLAG && (LCD_TRANSPORT == LCD_TRANSPORT_BLOCKING)
+    { "busy_fallback",  TEST_BusyFallback },
+#endif
+};
+
+int main(void)
+{
+    uint8_t count = sizeof(test_cases) / sizeof(test_cases[0]);
+    
+    for (uint8_t i = 0; i < count; i++) {
+        test_name = test_cases[i].name;
+        test_cases[i].run();
+    
+        // Nothing may have reached a busy controller
+        TEST_CHECK(test_sim.violations == 0);
+        LCDx_DeInit(&test_lcd);
+    }
+    
+    printf("%u checks, %u failed\n", test_checks, test_failures);
+    return (test_failures != 0);
+}
@@ -0,0 +1,291 @@
+/**
+  ******************************************************************************
+  * @file           : stm32c0xx_hal.c
+  * @brief          : Minimal host stand-in for the STM32C0 HAL
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  * Time is virtual. I2C transfers go to devices registered with
+  * HOST_AttachI2C (e.g. the LCD simulator); each byte is delivered with the
+  * time it would reach the pins on a real bus. Blocking transfers advance
+  * virtual time by their wire time, DMA/IT transfers run "in the background"
+  * and the handle stays busy until virtual time passes their end.
+  */
+
+#include "stm32c0xx_hal.h"
+#include "LCD.h"
+#include <string.h>
+
+/* Private defines -----------------------------------------------------------*/
+#define HOST_MAX_DEVICES        8
+
+/* Private types -------------------------------------------------------------*/
+typedef struct {
+    uint8_t addr;
+    HOST_I2CDeviceTypeDef device;
+} HOST_SlotTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t host_micros = 0;
+static uint64_t host_bus_free = 0;      // End of the last transfer on the wire
+static uint64_t host_async_end = 0;     // End of the running DMA/IT transfer
+static uint32_t host_i2c_hz = 100000;
+static HOST_SlotTypeDef host_slots[HOST_MAX_DEVICES];
+
+/* Public variables ----------------------------------------------------------*/
+SysTick_Type HostSysTick = {0, 47999, 0, 0};
+uint32_t SystemCoreClock = 48000000;
+HOST_BusStatsTypeDef HOST_BusStats;
+
+/* Private function prototypes -----------------------------------------------*/
+static HOST_I2CDeviceTypeDef* HOST_Find(uint16_t addr);
+static uint64_t HOST_Bits(uint32_t bits);
+static HAL_StatusTypeDef HOST_Write(uint16_t addr, const uint8_t* data, uint16_t size,
+                                    uint64_t* end);
+
+/* Time ----------------------------------------------------------------------*/
+
+uint64_t HOST_GetMicros(void)
+{
+    return host_micros;
+}
+
+void HOST_AdvanceMicros(uint64_t us)
+{
+    host_micros += us;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+    HOST_BusStats.delay_ms += Delay;
+    // Like the real HAL_Delay: waits at least one extra tick
+    host_micros += (uint64_t)(Delay + 1) * 1000U;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    // Polling loops must see time pass
+    host_micros += 1;
+    return (uint32_t)(host_micros / 1000U);
+}
+
+/**
+  * @brief  Replaces the SysTick busy-wait in LCD.c with virtual time
+  */
+void LCD_DelayUs(uint32_t us)
+{
+    HOST_BusStats.delay_us += us;
+    host_micros += us;
+}
+
+/* Host extensions -----------------------------------------------------------*/
+
+void HOST_ResetStats(void)
+{
+    memset(&HOST_BusStats, 0, sizeof(HOST_BusStats));
+}
+
+void HOST_SetI2CClock(uint32_t hz)
+{
+    host_i2c_hz = hz;
+}
+
+HAL_StatusTypeDef HOST_AttachI2C(uint8_t addr, const HOST_I2CDeviceTypeDef* device)
+{
+    HOST_SlotTypeDef* free_slot = NULL;
+    
+    for (uint8_t i = 0; i < HOST_MAX_DEVICES; i++) {
+        if (host_slots[i].device.dev != NULL && host_slots[i].addr == addr) {
+            free_slot = &host_slots[i];
+            break;
+        }
+        if (host_slots[i].device.dev == NULL && free_slot == NULL) {
+            free_slot = &host_slots[i];
+        }
+    }
+    
+    if (free_slot == NULL) {
+        return HAL_ERROR;
+    }
+    
+    free_slot->addr = addr;
+    if (device != NULL) {
+        free_slot->device = *device;
+    } else {
+        memset(&free_slot->device, 0, sizeof(free_slot->device));
+    }
+    return HAL_OK;
+}
+
+/* I2C -----------------------------------------------------------------------*/
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                          uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    uint64_t end;
+    HAL_StatusTypeDef status;
+    (void)Timeout;
+    
+    if (HAL_I2C_GetState(hi2c) == HAL_I2C_STATE_BUSY_TX) {
+        return HAL_BUSY;
+    }
+    
+    status = HOST_Write(DevAddress, pData, Size, &end);
+    host_micros = end;  // The CPU waits for the transfer
+    return status;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                         uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    HOST_I2CDeviceTypeDef* device = HOST_Find(DevAddress);
+    uint64_t start = (host_micros > host_bus_free) ? host_micros : host_bus_free;
+    (void)Timeout;
+    
+    if (HAL_I2C_GetState(hi2c) == HAL_I2C_STATE_BUSY_TX) {
+        return HAL_BUSY;
+    }
+    
+    HOST_BusStats.transactions++;
+    HOST_BusStats.reads++;
+    
+    if (device == NULL || device->read == NULL) {
+        // Address NACK: start, address byte, stop
+        host_micros = start + HOST_Bits(11);
+        HOST_BusStats.bus_bits += 11;
+        HOST_BusStats.bus_us += HOST_Bits(11);
+        host_bus_free = host_micros;
+        return HAL_ERROR;
+    }
+    
+    for (uint16_t i = 0; i < Size; i++) {
+        // Sampled when the byte starts after the address
+        pData[i] = device->read(device->dev, start + HOST_Bits(1 + 9 * (i + 1)));
+    }
+    
+    HOST_BusStats.bytes += Size;
+    HOST_BusStats.bus_bits += 2 + 9 * (Size + 1);
+    HOST_BusStats.bus_us += HOST_Bits(2 + 9 * (Size + 1));
+    host_micros = start + HOST_Bits(2 + 9 * (Size + 1));
+    host_bus_free = host_micros;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                              uint8_t* pData, uint16_t Size)
+{
+    HAL_StatusTypeDef status;
+    
+    if (HAL_I2C_GetState(hi2c) == HAL_I2C_STATE_BUSY_TX) {
+        return HAL_BUSY;
+    }
+    
+    // Delivered now, but the handle stays busy until the wire time has passed
+    status = HOST_Write(DevAddress, pData, Size, &host_async_end);
+    hi2c->State = HAL_I2C_STATE_BUSY_TX;
+    hi2c->ErrorCode = (status == HAL_OK) ? HAL_I2C_ERROR_NONE : 0x04U;  // AF
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                             uint8_t* pData, uint16_t Size)
+{
+    return HAL_I2C_Master_Transmit_DMA(hi2c, DevAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout)
+{
+    uint64_t start = (host_micros > host_bus_free) ? host_micros : host_bus_free;
+    (void)hi2c; (void)Timeout;
+    
+    if (Trials == 0) {
+        Trials = 1;
+    }
+    
+    // Each trial: start, address byte, stop
+    HOST_BusStats.transactions++;
+    if (HOST_Find(DevAddress) != NULL) {
+        Trials = 1;
+    }
+    HOST_BusStats.bus_bits += 11 * Trials;
+    HOST_BusStats.bus_us += HOST_Bits(11) * Trials;
+    host_micros = start + HOST_Bits(11) * Trials;
+    host_bus_free = host_micros;
+    
+    return (HOST_Find(DevAddress) != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef* hi2c)
+{
+    if (hi2c->State == HAL_I2C_STATE_BUSY_TX && host_micros >= host_async_end) {
+        hi2c->State = HAL_I2C_STATE_READY;
+    }
+    if (hi2c->State == HAL_I2C_STATE_RESET) {
+        hi2c->State = HAL_I2C_STATE_READY;
+    }
+    return hi2c->State;
+}
+
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c)
+{
+    return hi2c->ErrorCode;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Looks up the device at an address
+  */
+static HOST_I2CDeviceTypeDef* HOST_Find(uint16_t addr)
+{
+    for (uint8_t i = 0; i < HOST_MAX_DEVICES; i++) {
+        if (host_slots[i].device.dev != NULL && host_slots[i].addr == (uint8_t)addr) {
+            return &host_slots[i].device;
+        }
+    }
+    return NULL;
+}
+
+/**
+  * @brief  Wire time of a number of bit times, in microseconds (rounded up)
+  */
+static uint64_t HOST_Bits(uint32_t bits)
+{
+    return ((uint64_t)bits * 1000000U + host_i2c_hz - 1) / host_i2c_hz;
+}
+
+/**
+  * @brief  Delivers a write to the addressed device
+  * @note   Byte i reaches the pins at the end of its ACK bit
+  * @param  end: Set to the time the stop condition completes
+  */
+static HAL_StatusTypeDef HOST_Write(uint16_t addr, const uint8_t* data, uint16_t size,
+                                    uint64_t* end)
+{
+    HOST_I2CDeviceTypeDef* device = HOST_Find(addr);
+    uint64_t start = (host_micros > host_bus_free) ? host_micros : host_bus_free;
+    
+    HOST_BusStats.transactions++;
+    
+    if (device == NULL) {
+        // Address NACK: start, address byte, stop
+        *end = start + HOST_Bits(11);
+        HOST_BusStats.bus_bits += 11;
+        HOST_BusStats.bus_us += HOST_Bits(11);
+        host_bus_free = *end;
+        return HAL_ERROR;
+    }
+    
+    for (uint16_t i = 0; i < size; i++) {
+        device->write(device->dev, start + HOST_Bits(1 + 9 * (i + 2)), data[i]);
+    }
+    
+    *end = start + HOST_Bits(2 + 9 * (size + 1));
+    HOST_BusStats.bytes += size;
+    HOST_BusStats.bus_bits += 2 + 9 * (size + 1);
+    HOST_BusStats.bus_us += *end - start;
+    host_bus_free = *end;
+    return HAL_OK;
+}
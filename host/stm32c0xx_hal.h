@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file           : stm32c0xx_hal.h
+  * @brief          : Minimal host stand-in for the STM32C0 HAL
+  * @author         : Iwan Edogawa - ScoutLED
+  * @date           : 2025
+  * @target         : Linux / host builds
+  ******************************************************************************
+  * Only the types and functions LCD.c uses. Lets the driver be compiled and
+  * exercised on a PC; time is virtual and advanced by the delay functions.
+  */
+
+#ifndef __STM32C0XX_HAL_H
+#define __STM32C0XX_HAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __weak                  __attribute__((weak))
+#define __ALIGNED(x)            __attribute__((aligned(x)))
+
+typedef enum {
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum {
+    HAL_I2C_STATE_RESET = 0,
+    HAL_I2C_STATE_READY,
+    HAL_I2C_STATE_BUSY_TX
+} HAL_I2C_StateTypeDef;
+
+#define HAL_I2C_ERROR_NONE      0x00000000U
+
+typedef struct {
+    void* Instance;                     // Unused on the host
+    HAL_I2C_StateTypeDef State;
+    uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+typedef struct {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+} SysTick_Type;
+
+extern SysTick_Type HostSysTick;
+extern uint32_t SystemCoreClock;
+#define SysTick                 (&HostSysTick)
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+
+void HAL_Delay(uint32_t Delay);
+uint32_t HAL_GetTick(void);
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                          uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                         uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                              uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                             uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef* hi2c, uint16_t DevAddress,
+                                        uint32_t Trials, uint32_t Timeout);
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef* hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef* hi2c);
+
+/* Host extensions -----------------------------------------------------------*/
+
+/**
+  * @brief  Bus and delay counters, reset with HOST_ResetStats
+  */
+typedef struct {
+    uint32_t transactions;      // I2C transactions (writes and reads)
+    uint32_t bytes;             // Data bytes, address bytes not included
+    uint32_t reads;             // Read transactions
+    uint64_t bus_bits;          // Bit times incl. start, address, ACK, stop
+    uint64_t bus_us;            // Wire time of all transactions
+    uint32_t delay_ms;          // Sum of HAL_Delay arguments
+    uint64_t delay_us;          // Sum of LCD_DelayUs arguments
+} HOST_BusStatsTypeDef;
+
+/**
+  * @brief  Device on the simulated I2C bus
+  * @note   write is called for every data byte with the time its pins
+  *         change; read returns the pin state sampled at a given time
+  */
+typedef struct {
+    void (*write)(void* dev, uint64_t t_us, uint8_t data);
+    uint8_t (*read)(void* dev, uint64_t t_us);
+    void* dev;
+} HOST_I2CDeviceTypeDef;
+
+extern HOST_BusStatsTypeDef HOST_BusStats;
+
+/**
+  * @brief  Clears HOST_BusStats
+  */
+void HOST_ResetStats(void);
+
+/**
+  * @brief  Sets the simulated I2C clock (default 100 kHz)
+  * @param  hz: Bus clock in Hz
+  */
+void HOST_SetI2CClock(uint32_t hz);
+
+/**
+  * @brief  Puts a device on the bus; unattached addresses NACK
+  * @param  addr: Shifted 8-bit address
+  * @param  device: Callbacks, or NULL to detach (copied)
+  * @retval HAL_OK, or HAL_ERROR if the device table is full
+  */
+HAL_StatusTypeDef HOST_AttachI2C(uint8_t addr, const HOST_I2CDeviceTypeDef* device);
+
+/**
+  * @brief  Current virtual time in microseconds
+  */
+uint64_t HOST_GetMicros(void);
+
+/**
+  * @brief  Advances virtual time
+  * @param  us: Microseconds to add
+  */
+void HOST_AdvanceMicros(uint64_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STM32C0XX_HAL_H */